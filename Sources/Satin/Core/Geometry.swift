@@ -40,10 +40,7 @@ open class Geometry: Codable {
     public var primitiveType: MTLPrimitiveType = .triangle {
         didSet {
             if primitiveType != oldValue, primitiveType != .triangle {
-                if let bvh = _bvh {
-                    freeBVH(bvh)
-                }
-                _bvh = nil
+                releaseBVH()
             }
         }
     }
@@ -53,20 +50,47 @@ open class Geometry: Codable {
 
     public let publisher = PassthroughSubject<Geometry, Never>()
 
-    public var vertexData: [Vertex] = [] {
-        didSet {
+    /// Reading copies the vertices out and writing copies them in, build arrays before assigning
+    /// them and use withVertexData or mutateGeometryData to work on the storage in place
+    public var vertexData: [Vertex] {
+        get {
+            withVertexData { Array($0) }
+        }
+        set {
+            let current = storage
+            storage = newValue.withUnsafeBytes { vertices in
+                GeometryDataStorage(copying: vertices.baseAddress, newValue.count, UnsafeRawPointer(current.data.indexData), current.indexCount)
+            }
             publisher.send(self)
             _updateVertexBuffer = true
         }
     }
 
-    public var indexData: [UInt32] = [] {
-        didSet {
+    public var indexData: [UInt32] {
+        get {
+            withIndexData { Array($0) }
+        }
+        set {
+            let current = storage
+            storage = newValue.withUnsafeBytes { indices in
+                GeometryDataStorage(copying: UnsafeRawPointer(current.data.vertexData), current.vertexCount, indices.baseAddress, newValue.count)
+            }
             publisher.send(self)
             _updateIndexBuffer = true
         }
     }
 
+    public var vertexCount: Int {
+        storage.vertexCount
+    }
+
+    public var indexCount: Int {
+        storage.indexCount
+    }
+
+    // the only copy of the geometry's data, Metal buffers and the BVH read it in place
+    private var storage = GeometryDataStorage(createGeometryData())
+
     public var bvh: BVH? {
         if _updateBVH, primitiveType == .triangle {
             setupBVH()
@@ -99,6 +123,8 @@ open class Geometry: Codable {
 
     private var _updateBVH = true
     private var _bvh: BVH?
+    // the BVH reads positions in place, this keeps them alive for as long as it does
+    private var bvhStorage: GeometryDataStorage?
 
     private var _updateBounds = true {
         didSet {
@@ -121,6 +147,7 @@ open class Geometry: Codable {
 
     public var vertexBuffer: MTLBuffer? {
         didSet {
+            vertexBufferWrapsStorage = false
             if let vertexBuffer = vertexBuffer {
                 vertexBuffers[VertexBufferIndex.Vertices] = vertexBuffer
             } else {
@@ -130,6 +157,8 @@ open class Geometry: Codable {
         }
     }
 
+    private var vertexBufferWrapsStorage = false
+
     public var indexBuffer: MTLBuffer? {
         didSet {
             _updateIndexBuffer = false
@@ -198,92 +227,137 @@ open class Geometry: Codable {
 
     private func setupVertexBuffer() {
         guard let device = context?.device else { return }
-        if !vertexData.isEmpty {
-            let stride = MemoryLayout<Vertex>.stride
-            let verticesSize = vertexData.count * stride
-            if let vertexBuffer = vertexBuffer, vertexBuffer.length == verticesSize {
-                vertexBuffer.contents().copyMemory(from: &vertexData, byteCount: verticesSize)
-            } else {
-                vertexBuffer = device.makeBuffer(bytes: vertexData, length: verticesSize, options: [])
-                vertexBuffer?.label = "Vertices"
-            }
-        } else {
+        let verticesSize = storage.vertexCount * MemoryLayout<Vertex>.stride
+        guard verticesSize > 0, let vertices = storage.data.vertexData else {
             vertexBuffer = nil
+            return
+        }
+
+        let wrapsStorage = getPageAlignedLength(vertices, verticesSize) > 0
+        // storage wrapped without a copy is never written through
+        if !wrapsStorage, let vertexBuffer = vertexBuffer, !vertexBufferWrapsStorage, vertexBuffer.length == verticesSize {
+            vertexBuffer.contents().copyMemory(from: vertices, byteCount: verticesSize)
+            _updateVertexBuffer = false
+        } else {
+            vertexBuffer = makeBuffer(device: device, storage: storage, bytes: vertices, length: verticesSize)
+            vertexBuffer?.label = "Vertices"
+            vertexBufferWrapsStorage = wrapsStorage
         }
     }
 
     private func setupIndexBuffer() {
         guard let device = context?.device else { return }
-        if !indexData.isEmpty {
-            let indicesSize = indexData.count * MemoryLayout.size(ofValue: indexData[0])
-            indexBuffer = device.makeBuffer(bytes: indexData, length: indicesSize, options: [])
-            indexBuffer?.label = "Indices"
-        } else {
-            indexBuffer = nil
+        let indicesSize = storage.indexCount * MemoryLayout<UInt32>.size
+        indexBuffer = makeBuffer(device: device, storage: storage, bytes: storage.data.indexData, length: indicesSize)
+        indexBuffer?.label = "Indices"
+    }
+
+    // Wraps page aligned storage without copying it, the buffer keeps the storage alive
+    private func makeBuffer(device: MTLDevice, storage: GeometryDataStorage, bytes: UnsafeMutableRawPointer?, length: Int) -> MTLBuffer? {
+        guard let bytes = bytes, length > 0 else { return nil }
+        let alignedLength = getPageAlignedLength(bytes, length)
+        if alignedLength > 0 {
+            return device.makeBuffer(bytesNoCopy: bytes, length: alignedLength, options: [], deallocator: { _, _ in
+                withExtendedLifetime(storage) {}
+            })
         }
+        return device.makeBuffer(bytes: bytes, length: length, options: [])
     }
 
-    private func setupBVH() {
-        _bvh = createBVH(getGeometryData(), false)
-        _updateBVH = false
+    /// Lends the geometry's data to body without copying it, body must not write to or keep it
+    public func withGeometryData<T>(_ body: (GeometryData) -> T) -> T {
+        let storage = storage
+        return withExtendedLifetime(storage) {
+            let data = storage.data
+            return body(createGeometryDataWithStorage(data.vertexData, data.vertexCount, data.indexData, data.indexCount, nil, nil))
+        }
     }
 
-    public func setFrom(_ geometryData: inout GeometryData) {
-        let vertexCount = Int(geometryData.vertexCount)
-        if vertexCount > 0, let data = geometryData.vertexData {
-            vertexData = Array(UnsafeBufferPointer(start: data, count: vertexCount))
-        } else {
-            vertexData = []
+    public func withVertexData<T>(_ body: (UnsafeBufferPointer<Vertex>) -> T) -> T {
+        let storage = storage
+        return withExtendedLifetime(storage) {
+            body(UnsafeBufferPointer(start: storage.data.vertexData, count: storage.vertexCount))
         }
+    }
 
-        let indexCount = Int(geometryData.indexCount) * 3
-        if indexCount > 0, let data = geometryData.indexData {
-            data.withMemoryRebound(to: UInt32.self, capacity: indexCount) { ptr in
-                indexData = Array(UnsafeBufferPointer(start: ptr, count: indexCount))
-            }
-        } else {
-            indexData = []
+    public func withIndexData<T>(_ body: (UnsafeBufferPointer<UInt32>) -> T) -> T {
+        let storage = storage
+        return withExtendedLifetime(storage) {
+            let indices = UnsafeRawPointer(storage.data.indexData)?.assumingMemoryBound(to: UInt32.self)
+            return body(UnsafeBufferPointer(start: indices, count: storage.indexCount))
         }
     }
 
-    public func getGeometryData() -> GeometryData {
-        var data = GeometryData()
-        data.vertexCount = Int32(vertexData.count)
-        data.indexCount = Int32(indexData.count / 3)
-
-        vertexData.withUnsafeMutableBufferPointer { vtxPtr in
-            data.vertexData = vtxPtr.baseAddress!
+    /// Edits the geometry's data in place. A no-copy Metal buffer may still be read by a frame in
+    /// flight and the BVH reads positions in place, so storage they share is copied first
+    public func mutateGeometryData(_ body: (inout GeometryData) -> Void) {
+        if !isKnownUniquelyReferenced(&storage) {
+            storage = GeometryDataStorage(copying: storage)
         }
 
-        if vertexBuffer != nil {
-            _updateVertexBuffer = false
-        }
+        body(&storage.data)
+        storage.didMutate()
 
-        indexData.withUnsafeMutableBufferPointer { indPtr in
-            let raw = UnsafeRawBufferPointer(indPtr)
-            let ptr = raw.bindMemory(to: TriangleIndices.self)
-            data.indexData = UnsafeMutablePointer(mutating: ptr.baseAddress!)
-        }
+        publisher.send(self)
+        _updateVertexBuffer = true
+        _updateIndexBuffer = true
+    }
 
-        if indexBuffer != nil {
-            _updateIndexBuffer = false
+    private func setupBVH() {
+        releaseBVH()
+        bvhStorage = storage
+        _bvh = createBVH(getGeometryData(), false)
+        _updateBVH = false
+    }
+
+    private func releaseBVH() {
+        if let bvh = _bvh {
+            freeBVH(bvh)
         }
+        _bvh = nil
+        bvhStorage = nil
+    }
+
+    public func setFrom(_ geometryData: inout GeometryData) {
+        storage = GeometryDataStorage(copying: UnsafeRawPointer(geometryData.vertexData), Int(geometryData.vertexCount), UnsafeRawPointer(geometryData.indexData), Int(geometryData.indexCount) * 3)
 
-        return data
+        publisher.send(self)
+        _updateVertexBuffer = true
+        _updateIndexBuffer = true
+    }
+
+    /// Takes over geometryData's storage without copying it and leaves geometryData empty
+    public func adopt(_ geometryData: inout GeometryData) {
+        storage = GeometryDataStorage(geometryData)
+        geometryData = createGeometryData()
+
+        publisher.send(self)
+        _updateVertexBuffer = true
+        _updateIndexBuffer = true
+    }
+
+    /// The returned data is borrowed, it stays owned by the geometry and valid until the geometry's
+    /// data is next set or mutated
+    public func getGeometryData() -> GeometryData {
+        let data = storage.data
+        return createGeometryDataWithStorage(data.vertexData, data.vertexCount, data.indexData, data.indexCount, nil, nil)
     }
 
     public func unroll() -> Geometry {
-        var data = getGeometryData()
         var unrolled = GeometryData()
-        unrollGeometryData(&unrolled, &data)
+        withGeometryData { data in
+            var data = data
+            unrollGeometryData(&unrolled, &data)
+        }
         setFrom(&unrolled)
         freeGeometryData(&unrolled)
         return self
     }
 
     public func computeNormals() {
-        var data = getGeometryData()
-        computeNormalsOfGeometryData(&data)
+        mutateGeometryData { data in
+            computeNormalsOfGeometryData(&data)
+        }
     }
 
     public func setBuffer(_ buffer: MTLBuffer?, type: VertexBufferIndex) {
@@ -292,7 +366,9 @@ open class Geometry: Codable {
     }
 
     public func transform(_ matrix: simd_float4x4) {
-        transformVertices(&vertexData, Int32(vertexData.count), matrix)
+        mutateGeometryData { data in
+            transformGeometryData(&data, matrix)
+        }
     }
 
     public func intersects(ray: Ray) -> Bool {
@@ -309,22 +385,70 @@ open class Geometry: Codable {
         if primitiveType == .triangle, let bvh = bvh, let node = bvh.getNode(index: 0) {
             return node.aabb
         }
-        return computeBoundsFromVertices(&vertexData, Int32(vertexData.count))
+        return withGeometryData { data in
+            computeBoundsFromVertices(data.vertexData, data.vertexCount)
+        }
     }
 
     deinit {
-        indexData = []
-        vertexData = []
         vertexBuffer = nil
         indexBuffer = nil
-        if let bvh = _bvh {
-            freeBVH(bvh)
-            self._bvh = nil
-        }
+        releaseBVH()
         vertexBuffers.removeAll()
     }
 }
 
+/// Keeps a geometry's SatinCore storage alive for it, its BVH and the Metal buffers wrapping it
+final class GeometryDataStorage {
+    var data: GeometryData
+    // UInt32 indices, lines and points don't always fill whole triangles
+    private(set) var indexCount: Int
+
+    var vertexCount: Int { Int(data.vertexCount) }
+
+    init(_ data: GeometryData) {
+        self.data = data
+        indexCount = Int(data.indexCount) * 3
+    }
+
+    /// Copies the arrays into page aligned storage so Metal can wrap them, a partial last
+    /// triangle is padded with zeros
+    convenience init(copying vertices: UnsafeRawPointer?, _ vertexCount: Int, _ indices: UnsafeRawPointer?, _ indexCount: Int) {
+        var data = createGeometryData()
+        if vertexCount > 0, let vertices = vertices, let vertexData = allocateVertexData(Int32(vertexCount)) {
+            UnsafeMutableRawPointer(vertexData).copyMemory(from: vertices, byteCount: vertexCount * MemoryLayout<Vertex>.stride)
+            data.vertexData = vertexData
+            data.vertexCount = Int32(vertexCount)
+        }
+        let triangleCount = (indexCount + 2) / 3
+        if triangleCount > 0, let indices = indices, let indexData = allocateIndexData(Int32(triangleCount)) {
+            let byteCount = indexCount * MemoryLayout<UInt32>.size
+            UnsafeMutableRawPointer(indexData).copyMemory(from: indices, byteCount: byteCount)
+            (UnsafeMutableRawPointer(indexData) + byteCount).initializeMemory(as: UInt8.self, repeating: 0, count: triangleCount * MemoryLayout<TriangleIndices>.stride - byteCount)
+            data.indexData = indexData
+            data.indexCount = Int32(triangleCount)
+        }
+        self.init(data)
+        self.indexCount = data.indexData != nil ? indexCount : 0
+    }
+
+    convenience init(copying storage: GeometryDataStorage) {
+        let data = storage.data
+        self.init(copying: UnsafeRawPointer(data.vertexData), storage.vertexCount, UnsafeRawPointer(data.indexData), storage.indexCount)
+    }
+
+    /// SatinCore only sees whole triangles, a body that resized them owns the count again
+    func didMutate() {
+        if (indexCount + 2) / 3 != Int(data.indexCount) {
+            indexCount = Int(data.indexCount) * 3
+        }
+    }
+
+    deinit {
+        freeGeometryData(&data)
+    }
+}
+
 extension Geometry: Equatable {
     public static func == (lhs: Geometry, rhs: Geometry) -> Bool {
         return lhs === rhs
@@ -40,10 +40,15 @@ public extension BVH {
     }
 
     func getPosition(index: UInt32) -> simd_float3 {
-        return positions.advanced(by: Int(index)).pointee
+        let p = positions.advanced(by: Int(index) * Int(positionStride)).assumingMemoryBound(to: Float.self)
+        return simd_float3(p[0], p[1], p[2])
     }
 
+    /// BVHs built from bare positions (createBVHFromPositions) have no vertices
+    var hasVertices: Bool { geometry.vertexData != nil }
+
     func getVertex(index: UInt32) -> Vertex {
+        precondition(hasVertices, "BVH was built from positions only")
         return geometry.vertexData[Int(index)]
     }
 
@@ -74,9 +79,13 @@ public extension BVH {
             if rayTriangleIntersectionTime(ray, a, b, c, &time), time > .leastNonzeroMagnitude {
                 let intersection = ray.at(time)
                 let bc = getBarycentricCoordinates(intersection, a, b, c)
-                let v0 = getVertex(index: triangle.i0)
-                let v1 = getVertex(index: triangle.i1)
-                let v2 = getVertex(index: triangle.i2)
+                var uv = simd_float2(repeating: 0)
+                if hasVertices {
+                    let v0 = getVertex(index: triangle.i0)
+                    let v1 = getVertex(index: triangle.i1)
+                    let v2 = getVertex(index: triangle.i2)
+                    uv = v0.uv * bc.x + v1.uv * bc.y + v2.uv * bc.z
+                }
 
                 intersections.append(
                     IntersectionResult(
@@ -84,7 +93,7 @@ public extension BVH {
                         distance: simd_length(intersection - ray.origin),
                         normal: simd_normalize(simd_cross(b - a, c - a)),
                         position: intersection,
-                        uv: v0.uv * bc.x + v1.uv * bc.y + v2.uv * bc.z,
+                        uv: uv,
                         primitiveIndex: primitiveIndex
                     )
                 )
@@ -93,12 +102,38 @@ public extension BVH {
     }
 
     func intersect(ray: Ray, intersections: inout [IntersectionResult], index: UInt32 = 0) {
+        // only rays cast while profiling pay for the counting and the call into SatinCore
+        guard isProfilingEnabled() else {
+            traverse(ray: ray, intersections: &intersections, index: index)
+            return
+        }
+
+        var nodesVisited: UInt64 = 0
+        var trianglesTested: UInt64 = 0
+        traverse(ray: ray, intersections: &intersections, index: index, nodesVisited: &nodesVisited, trianglesTested: &trianglesTested)
+        addBVHRayProfile(nodesVisited, trianglesTested)
+    }
+
+    private func traverse(ray: Ray, intersections: inout [IntersectionResult], index: UInt32) {
         guard let node = getNode(index: index), node.intersects(ray: ray) else { return }
         if node.isLeaf {
             intersectTriangles(ray: ray, node: node, intersections: &intersections)
         } else {
-            intersect(ray: ray, intersections: &intersections, index: node.leftFirst)
-            intersect(ray: ray, intersections: &intersections, index: node.leftFirst + 1)
+            traverse(ray: ray, intersections: &intersections, index: node.leftFirst)
+            traverse(ray: ray, intersections: &intersections, index: node.leftFirst + 1)
+        }
+    }
+
+    private func traverse(ray: Ray, intersections: inout [IntersectionResult], index: UInt32, nodesVisited: inout UInt64, trianglesTested: inout UInt64) {
+        guard let node = getNode(index: index) else { return }
+        nodesVisited += 1
+        guard node.intersects(ray: ray) else { return }
+        if node.isLeaf {
+            trianglesTested += UInt64(node.triCount)
+            intersectTriangles(ray: ray, node: node, intersections: &intersections)
+        } else {
+            traverse(ray: ray, intersections: &intersections, index: node.leftFirst, nodesVisited: &nodesVisited, trianglesTested: &trianglesTested)
+            traverse(ray: ray, intersections: &intersections, index: node.leftFirst + 1, nodesVisited: &nodesVisited, trianglesTested: &trianglesTested)
         }
     }
 }
@@ -21,7 +21,6 @@ open class ArcGeometry: Geometry {
 
     func setupData(radius: (inner: Float, outer: Float), angle: (start: Float, end: Float), res: (angular: Int, radial: Int)) {
         var geometryData = generateArcGeometryData(radius.inner, radius.outer, angle.start, angle.end, Int32(res.angular), Int32(res.radial))
-        setFrom(&geometryData)
-        freeGeometryData(&geometryData)
+        adopt(&geometryData)
     }
 }
@@ -49,13 +49,11 @@ open class BoxGeometry: Geometry {
         let size = bounds.size
         let center = bounds.center
         var geometryData = generateBoxGeometryData(size.x, size.y, size.z, center.x, center.y, center.z, Int32(res.width), Int32(res.height), Int32(res.depth))
-        setFrom(&geometryData)
-        freeGeometryData(&geometryData)
+        adopt(&geometryData)
     }
 
     func setupData(width: Float, height: Float, depth: Float, resWidth: Int, resHeight: Int, resDepth: Int) {
         var geometryData = generateBoxGeometryData(width, height, depth, 0.0, 0.0, 0.0, Int32(resWidth), Int32(resHeight), Int32(resDepth))
-        setFrom(&geometryData)
-        freeGeometryData(&geometryData)
+        adopt(&geometryData)
     }
 }
@@ -32,7 +32,6 @@ open class CapsuleGeometry: Geometry {
 
     func setupData(size: (radius: Float, height: Float), res: (angular: Int, radial: Int, vertical: Int), axis: Axis) {
         var geometryData = generateCapsuleGeometryData(size.radius, size.height, Int32(res.angular), Int32(res.radial), Int32(res.vertical), axis.rawValue)
-        setFrom(&geometryData)
-        freeGeometryData(&geometryData)
+        adopt(&geometryData)
     }
 }
@@ -34,7 +34,6 @@ open class CircleGeometry: Geometry {
 
     func setupData(radius: Float, res: (angular: Int, radial: Int)) {
         var geometryData = generateCircleGeometryData(radius, Int32(res.angular), Int32(res.radial))
-        setFrom(&geometryData)
-        freeGeometryData(&geometryData)
+        adopt(&geometryData)
     }
 }
@@ -25,7 +25,6 @@ open class CylinderGeometry: Geometry {
 
     func setupData(size: (radius: Float, height: Float), res: (angular: Int, radial: Int, vertical: Int)) {
         var geometryData = generateCylinderGeometryData(size.radius, size.height, Int32(res.angular), Int32(res.radial), Int32(res.vertical))
-        setFrom(&geometryData)
-        freeGeometryData(&geometryData)
+        adopt(&geometryData)
     }
 }
@@ -32,7 +32,6 @@ open class ExtrudedRoundedRectGeometry: Geometry {
     func setupData(size: (width: Float, height: Float, depth: Float), radius: Float, res: (corner: Int, edgeX: Int, edgeY: Int, edgeZ: Int, radial: Int)) {
         primitiveType = .triangle
         var geometryData = generateExtrudedRoundedRectGeometryData(size.width, size.height, size.depth, radius, Int32(res.corner), Int32(res.edgeX), Int32(res.edgeY), Int32(res.edgeZ), Int32(res.radial))
-        setFrom(&geometryData)
-        freeGeometryData(&geometryData)
+        adopt(&geometryData)
     }
 }
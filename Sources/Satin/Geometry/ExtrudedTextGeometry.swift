@@ -51,11 +51,11 @@ open class ExtrudedTextGeometry: TextGeometry {
         characterPaths[char] = []
 
         // front face character data
-        var cData = GeometryData(vertexCount: 0, vertexData: nil, indexCount: 0, indexData: nil)
+        var cData = createGeometryData()
         // back face character data
-        var bData = GeometryData(vertexCount: 0, vertexData: nil, indexCount: 0, indexData: nil)
+        var bData = createGeometryData()
         // side faces character data
-        var sData = GeometryData(vertexCount: 0, vertexData: nil, indexCount: 0, indexData: nil)
+        var sData = createGeometryData()
 
         if let cacheData = geometryCache[char], let cacheReverseData = geometryReverseCache[char],
            let cacheExtrudeData = geometryExtrudeCache[char], let charPaths = characterPathsCache[char]
@@ -25,7 +25,6 @@ open class IcoSphereGeometry: Geometry {
 
     func setupData(radius: Float, res: Int) {
         var geometryData = generateIcoSphereGeometryData(radius, Int32(res))
-        setFrom(&geometryData)
-        freeGeometryData(&geometryData)
+        adopt(&geometryData)
     }
 }
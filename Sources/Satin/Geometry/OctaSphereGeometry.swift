@@ -24,7 +24,6 @@ open class OctaSphereGeometry: Geometry {
 
     func setupData(radius: Float, res: Int) {
         var geometryData = generateOctaSphereGeometryData(radius, Int32(res))
-        setFrom(&geometryData)
-        freeGeometryData(&geometryData)
+        adopt(&geometryData)
     }
 }
@@ -32,6 +32,11 @@ open class ParametricGeometry: Geometry {
         let uminf = Float(u.min)
         let vminf = Float(v.min)
 
+        var vertices: [Vertex] = []
+        vertices.reserveCapacity((ru + 1) * (rv + 1))
+        var indices: [UInt32] = []
+        indices.reserveCapacity(ru * rv * 6)
+
         for v in 0 ... rv {
             let vf = Float(v)
             let vIn = vminf + vf * rvInc
@@ -71,7 +76,7 @@ open class ParametricGeometry: Geometry {
                     normal.z = normal.z / sum
                 }
 
-                vertexData.append(
+                vertices.append(
                     Vertex(
                         position: simd_make_float4(pos, 1.0),
                         normal: normal,
@@ -88,14 +93,17 @@ open class ParametricGeometry: Geometry {
                     let bl = index + perLoop
                     let br = bl + 1
 
-                    indexData.append(UInt32(tl))
-                    indexData.append(UInt32(tr))
-                    indexData.append(UInt32(bl))
-                    indexData.append(UInt32(tr))
-                    indexData.append(UInt32(br))
-                    indexData.append(UInt32(bl))
+                    indices.append(UInt32(tl))
+                    indices.append(UInt32(tr))
+                    indices.append(UInt32(bl))
+                    indices.append(UInt32(tr))
+                    indices.append(UInt32(br))
+                    indices.append(UInt32(bl))
                 }
             }
         }
+
+        vertexData = vertices
+        indexData = indices
     }
 }
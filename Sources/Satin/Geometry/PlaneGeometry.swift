@@ -99,7 +99,6 @@ open class PlaneGeometry: Geometry {
 
     func setupData(width: Float, height: Float, resU: Int, resV: Int, plane: PlaneOrientation = .xy, centered: Bool = true) {
         var geometryData = generatePlaneGeometryData(width, height, Int32(resU), Int32(resV), plane.rawValue, centered)
-        setFrom(&geometryData)
-        freeGeometryData(&geometryData)
+        adopt(&geometryData)
     }
 }
@@ -19,12 +19,12 @@ open class PointGeometry: Geometry {
 
     func setupData() {
         primitiveType = .point
-        vertexData.append(
+        vertexData = [
             Vertex(
                 position: [0.0, 0.0, 0.0, 1.0],
                 normal: [0.0, 0.0, 1.0],
                 uv: [0.0, 0.0]
             )
-        )
+        ]
     }
 }
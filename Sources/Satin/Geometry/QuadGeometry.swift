@@ -20,7 +20,6 @@ open class QuadGeometry: Geometry {
 
     func setupData(size: Float) {
         var geometryData = generateQuadGeometryData(size)
-        setFrom(&geometryData)
-        freeGeometryData(&geometryData)
+        adopt(&geometryData)
     }
 }
@@ -29,7 +29,6 @@ open class RoundedBoxGeometry: Geometry {
 
     func setupData(width: Float, height: Float, depth: Float, radius: Float, res: Int) {
         var geometryData = generateRoundedBoxGeometryData(width, height, depth, radius, Int32(res))
-        setFrom(&geometryData)
-        freeGeometryData(&geometryData)
+        adopt(&geometryData)
     }
 }
@@ -28,7 +28,6 @@ open class RoundedRectGeometry: Geometry {
 
     func setupData(size: (width: Float, height: Float), radius: Float, res: (corner: Int, edgeX: Int, edgeY: Int, radial: Int)) {
         var geometryData = generateRoundedRectGeometryData(size.width, size.height, radius, Int32(res.corner), Int32(res.edgeX), Int32(res.edgeY), Int32(res.radial))
-        setFrom(&geometryData)
-        freeGeometryData(&geometryData)
+        adopt(&geometryData)
     }
 }
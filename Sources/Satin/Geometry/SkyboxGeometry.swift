@@ -18,7 +18,6 @@ open class SkyboxGeometry: Geometry {
 
     func setupData(size: Float) {
         var geometryData = generateSkyboxGeometryData(size)
-        setFrom(&geometryData)
-        freeGeometryData(&geometryData)
+        adopt(&geometryData)
     }
 }
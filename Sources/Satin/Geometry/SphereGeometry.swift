@@ -33,7 +33,6 @@ open class SphereGeometry: Geometry {
 
     func setupData(radius: Float, res: (angular: Int, vertical: Int)) {
         var geometryData = generateSphereGeometryData(radius, Int32(res.angular), Int32(res.vertical))
-        setFrom(&geometryData)
-        freeGeometryData(&geometryData)
+        adopt(&geometryData)
     }
 }
@@ -19,7 +19,6 @@ open class SquircleGeometry: Geometry {
 
     func setupData(size: Float, p: Float, res: (angular: Int, radial: Int)) {
         var geometryData = generateSquircleGeometryData(size, p, Int32(res.angular), Int32(res.radial))
-        setFrom(&geometryData)
-        freeGeometryData(&geometryData)
+        adopt(&geometryData)
     }
 }
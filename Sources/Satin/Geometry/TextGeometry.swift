@@ -350,7 +350,7 @@ open class TextGeometry: Geometry {
     var angleLimit: Float = degToRad(7.5)
 
     func setupData() {
-        var gData = GeometryData(vertexCount: 0, vertexData: nil, indexCount: 0, indexData: nil)
+        var gData = createGeometryData()
 
         if needsClear {
             clearCache()
@@ -378,8 +378,7 @@ open class TextGeometry: Geometry {
             }
         }
 
-        setFrom(&gData)
-        freeGeometryData(&gData)
+        adopt(&gData)
     }
 
     func addGlyphGeometryData(_ gData: inout GeometryData, _ charOffset: Int, _ glyph: CGGlyph, _ glyphPosition: CGPoint, _ origin: CGPoint) {
@@ -389,7 +388,7 @@ open class TextGeometry: Geometry {
         let char = text[charIndex]
         characterPaths[char] = []
 
-        var cData = GeometryData(vertexCount: 0, vertexData: nil, indexCount: 0, indexData: nil)
+        var cData = createGeometryData()
 
         if let cacheData = geometryCache[char], let charPaths = characterPathsCache[char] {
             cData = cacheData
@@ -25,7 +25,6 @@ open class TorusGeometry: Geometry {
 
     func setupData(radius: (minor: Float, major: Float), res: (minor: Int, major: Int)) {
         var geometryData = generateTorusGeometryData(radius.minor, radius.major, Int32(res.minor), Int32(res.major))
-        setFrom(&geometryData)
-        freeGeometryData(&geometryData)
+        adopt(&geometryData)
     }
 }
@@ -20,7 +20,6 @@ open class TriangleGeometry: Geometry {
 
     func setupData(size: Float) {
         var geometryData = generateTriangleGeometryData(size)
-        setFrom(&geometryData)
-        freeGeometryData(&geometryData)
+        adopt(&geometryData)
     }
 }
@@ -24,7 +24,6 @@ open class TubeGeometry: Geometry {
 
     func setupData(size: (radius: Float, height: Float), angles: (start: Float, end: Float), res: (angular: Int, vertical: Int)) {
         var geometryData = generateTubeGeometryData(size.radius, size.height, angles.start, angles.end, Int32(res.angular), Int32(res.vertical))
-        setFrom(&geometryData)
-        freeGeometryData(&geometryData)
+        adopt(&geometryData)
     }
 }
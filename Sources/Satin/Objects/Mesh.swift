@@ -252,7 +252,7 @@ open class Mesh: Object, Renderable {
             if let indexBuffer = geometry.indexBuffer {
                 renderEncoder.drawIndexedPrimitives(
                     type: geometry.primitiveType,
-                    indexCount: geometry.indexData.count,
+                    indexCount: geometry.indexCount,
                     indexType: geometry.indexType,
                     indexBuffer: indexBuffer,
                     indexBufferOffset: 0,
@@ -262,7 +262,7 @@ open class Mesh: Object, Renderable {
                 renderEncoder.drawPrimitives(
                     type: geometry.primitiveType,
                     vertexStart: 0,
-                    vertexCount: geometry.vertexData.count,
+                    vertexCount: geometry.vertexCount,
                     instanceCount: instanceCount
                 )
             }
@@ -279,12 +279,26 @@ simd_float3 cubicBezier3(simd_float3 a, simd_float3 b, simd_float3 c, simd_float
            3.0 * oneMinusT * t * t * c + t * t * t * d;
 }
 
+simd_float3 cubicBezierVelocity3(simd_float3 a, simd_float3 b, simd_float3 c, simd_float3 d,
+                                 float t)
+{
+    float oneMinusT = 1.0 - t;
+    float oneMinusT2 = oneMinusT * oneMinusT;
+    return 3.0 * oneMinusT2 * (b - a) + 6.0 * oneMinusT * t * (c - b) + 3.0 * t * t * (d - c);
+}
+
 simd_float3 quadraticBezier3(simd_float3 a, simd_float3 b, simd_float3 c, float t)
 {
     float oneMinusT = 1.0 - t;
     return oneMinusT * oneMinusT * a + 2.0 * oneMinusT * t * b + t * t * c;
 }
 
+simd_float3 quadraticBezierVelocity3(simd_float3 a, simd_float3 b, simd_float3 c, float t)
+{
+    float oneMinusT = 1.0 - t;
+    return 2.0 * oneMinusT * (b - a) + 2 * t * (c - b);
+}
+
 void freePolyline3D(Polyline3D *line)
 {
     if (line->count <= 0 && line->data == NULL) { return; }
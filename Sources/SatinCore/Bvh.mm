@@ -7,6 +7,7 @@
 
 #include "Bvh.h"
 #include "Bounds.h"
+#include "Profiler.h"
 #include <float.h>
 #include <malloc/_malloc.h>
 #include <simd/simd.h>
@@ -24,6 +25,23 @@ Bin createBin() { return (Bin) { .aabb = createBounds(), .triCount = 0 }; }
 
 bool isLeaf(BVHNode node) { return node.triCount > 0; }
 
+static inline simd_float3 getBVHPosition(const BVH *bvh, uint32_t index)
+{
+    const float *p =
+        (const float *)((const uint8_t *)bvh->positions + (size_t)index * bvh->positionStride);
+    return simd_make_float3(p[0], p[1], p[2]);
+}
+
+static inline void expandBoundsWithBVHTriangle(Bounds *bounds, const BVH *bvh, TriangleIndices tri)
+{
+    const simd_float3 p0 = getBVHPosition(bvh, tri.i0);
+    const simd_float3 p1 = getBVHPosition(bvh, tri.i1);
+    const simd_float3 p2 = getBVHPosition(bvh, tri.i2);
+    expandBoundsInPlace(bounds, &p0);
+    expandBoundsInPlace(bounds, &p1);
+    expandBoundsInPlace(bounds, &p2);
+}
+
 float surfaceAreaBounds(Bounds *b)
 {
     for (int i = 0; i < 3; i++) {
@@ -71,9 +89,7 @@ float findBestSplitPlane(BVH *bvh, BVHNode *node, int *axis, float *splitPos)
 
         bin[binID].triCount++;
 
-        expandBoundsInPlace(&bin[binID].aabb, &bvh->positions[tri.i0]);
-        expandBoundsInPlace(&bin[binID].aabb, &bvh->positions[tri.i1]);
-        expandBoundsInPlace(&bin[binID].aabb, &bvh->positions[tri.i2]);
+        expandBoundsWithBVHTriangle(&bin[binID].aabb, bvh, tri);
     }
 
     // gather data for the 7 planes between the 8 bins
@@ -95,6 +111,7 @@ float findBestSplitPlane(BVH *bvh, BVHNode *node, int *axis, float *splitPos)
     }
 
     // calculate SAH cost for the 7 planes
+    addProfileCounter(ProfileCounterBVHSAHEvaluations, BINSMINUSONE);
     scale = (boundsMax - boundsMin) / (float)BINS;
     for (int i = 0; i < BINSMINUSONE; i++) {
         const float planeCost = leftCount[i] * leftArea[i] + rightCount[i] * rightArea[i];
@@ -114,9 +131,7 @@ void updateBVHNodeBounds(BVH *bvh, uint32_t nodeIndex)
     for (uint32_t first = node->leftFirst, i = 0; i < node->triCount; i++) {
         const uint32_t triID = bvh->triIDs[first + i];
         const TriangleIndices tri = bvh->triangles[triID];
-        expandBoundsInPlace(&node->aabb, &bvh->positions[tri.i0]);
-        expandBoundsInPlace(&node->aabb, &bvh->positions[tri.i1]);
-        expandBoundsInPlace(&node->aabb, &bvh->positions[tri.i2]);
+        expandBoundsWithBVHTriangle(&node->aabb, bvh, tri);
     }
 }
 
@@ -177,62 +192,53 @@ void subdivideBVHNode(BVH *bvh, uint32_t nodeIndex)
     subdivideBVHNode(bvh, rightNodeIndex);
 }
 
-BVH createBVH(GeometryData geometry, bool useSAH)
+BVH createBVHFromPositions(const void *positions, uint32_t positionStride, int vertexCount,
+                           const TriangleIndices *triangles, int triangleCount, bool useSAH)
 {
-    const bool hasTriangles = geometry.indexCount > 0;
-    const uint32_t N = hasTriangles ? geometry.indexCount : (geometry.vertexCount / 3);
+    ProfileSpan span("createBVH");
+
+    const bool hasTriangles = triangles != NULL && triangleCount > 0;
+    const uint32_t N = hasTriangles ? triangleCount : (vertexCount / 3);
 
     BVHNode *nodes = (BVHNode *)malloc(sizeof(BVHNode) * N * 2 - 1);
     simd_float3 *centroids = (simd_float3 *)malloc(sizeof(simd_float3) * N);
-    simd_float3 *positions = (simd_float3 *)malloc(sizeof(simd_float3) * geometry.vertexCount);
     uint32_t *triIDs = (uint32_t *)malloc(sizeof(uint32_t) * N);
-    TriangleIndices *triangles = (TriangleIndices *)malloc(sizeof(TriangleIndices) * N);
     Bounds aabb = createBounds();
 
-    if (hasTriangles) {
-        for (uint32_t i = 0; i < N; i++) {
-            triIDs[i] = i;
-            const TriangleIndices tri = geometry.indexData[i];
-            triangles[i] = tri;
-
-            positions[tri.i0] = geometry.vertexData[tri.i0].position.xyz;
-            positions[tri.i1] = geometry.vertexData[tri.i1].position.xyz;
-            positions[tri.i2] = geometry.vertexData[tri.i2].position.xyz;
-
-            expandBoundsInPlace(&aabb, &positions[tri.i0]);
-            expandBoundsInPlace(&aabb, &positions[tri.i1]);
-            expandBoundsInPlace(&aabb, &positions[tri.i2]);
-
-            centroids[i] = (positions[tri.i0] + positions[tri.i1] + positions[tri.i2]) / 3.0;
-        }
-    }
-    else {
-        for (uint32_t i = 0; i < N; i++) {
-            triIDs[i] = i;
-            const TriangleIndices tri = (TriangleIndices) { i * 3, i * 3 + 1, i * 3 + 2 };
-            triangles[i] = tri;
-
-            positions[tri.i0] = geometry.vertexData[tri.i0].position.xyz;
-            positions[tri.i1] = geometry.vertexData[tri.i1].position.xyz;
-            positions[tri.i2] = geometry.vertexData[tri.i2].position.xyz;
-
-            expandBoundsInPlace(&aabb, &positions[tri.i0]);
-            expandBoundsInPlace(&aabb, &positions[tri.i1]);
-            expandBoundsInPlace(&aabb, &positions[tri.i2]);
-
-            centroids[i] = (positions[tri.i0] + positions[tri.i1] + positions[tri.i2]) / 3.0;
-        }
-    }
-
-    BVH bvh = (BVH) { .geometry = geometry,
+    BVH bvh = (BVH) { .geometry = createGeometryData(),
                       .nodes = nodes,
                       .centroids = centroids,
                       .positions = positions,
+                      .positionStride = positionStride,
                       .triangles = triangles,
+                      .ownsTriangles = !hasTriangles,
                       .triIDs = triIDs,
                       .nodesUsed = 0,
                       .useSAH = useSAH };
 
+    // unindexed positions get their implicit triangles spelled out
+    if (!hasTriangles) {
+        TriangleIndices *implicitTriangles = (TriangleIndices *)malloc(sizeof(TriangleIndices) * N);
+        for (uint32_t i = 0; i < N; i++) {
+            implicitTriangles[i] = (TriangleIndices) { i * 3, i * 3 + 1, i * 3 + 2 };
+        }
+        bvh.triangles = implicitTriangles;
+    }
+
+    for (uint32_t i = 0; i < N; i++) {
+        triIDs[i] = i;
+        const TriangleIndices tri = bvh.triangles[i];
+        const simd_float3 p0 = getBVHPosition(&bvh, tri.i0);
+        const simd_float3 p1 = getBVHPosition(&bvh, tri.i1);
+        const simd_float3 p2 = getBVHPosition(&bvh, tri.i2);
+
+        expandBoundsInPlace(&aabb, &p0);
+        expandBoundsInPlace(&aabb, &p1);
+        expandBoundsInPlace(&aabb, &p2);
+
+        centroids[i] = (p0 + p1 + p2) / 3.0;
+    }
+
     if (N > 0) {
         bvh.nodesUsed++;
         BVHNode *root = &nodes[0];
@@ -242,6 +248,16 @@ BVH createBVH(GeometryData geometry, bool useSAH)
         subdivideBVHNode(&bvh, 0);
     }
 
+    addProfileCounter(ProfileCounterBVHNodesBuilt, bvh.nodesUsed);
+    span.setGeometry(vertexCount, N);
+    return bvh;
+}
+
+BVH createBVH(GeometryData geometry, bool useSAH)
+{
+    BVH bvh = createBVHFromPositions(geometry.vertexData, sizeof(Vertex), geometry.vertexCount,
+                                     geometry.indexData, geometry.indexCount, useSAH);
+    bvh.geometry = geometry;
     return bvh;
 }
 
@@ -250,6 +266,5 @@ void freeBVH(BVH bvh)
     free(bvh.triIDs);
     free(bvh.nodes);
     free(bvh.centroids);
-    free(bvh.positions);
-    free(bvh.triangles);
+    if (bvh.ownsTriangles) { free((void *)bvh.triangles); }
 }
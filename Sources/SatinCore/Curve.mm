@@ -0,0 +1,485 @@
+//
+//  Curve.mm
+//  Satin
+//
+//  Created by agent on 10/19/26.
+//
+
+#include <algorithm>
+#include <climits>
+#include <malloc/_malloc.h>
+
+#include "Bezier.h"
+#include "Curve.h"
+#include "Hermite.h"
+#include "Profiler.h"
+
+// Segments keep their control points and are evaluated with the Hermite & Bezier helpers,
+// batches only rebuild a segment (Catmull-Rom tangents) when they cross into the next one
+
+typedef struct CurveSegment {
+    CurveType type; // Catmull-Rom segments are stored as Hermite ones
+    simd_float3 p0, p1, p2, p3;
+} CurveSegment;
+
+typedef struct CurveCursor {
+    Curve3D curve;
+    int segmentCount;
+    int segment;
+    CurveSegment segmentData;
+} CurveCursor;
+
+int getCurveSegmentCount(Curve3D curve)
+{
+    if (curve.count < 2 || curve.points == NULL) { return 0; }
+    switch (curve.type) {
+        case CurveTypeHermite: return curve.tangents != NULL ? curve.count - 1 : 0;
+        case CurveTypeCatmullRom: return curve.count - 1;
+        case CurveTypeQuadraticBezier: return (curve.count - 1) / 2;
+        case CurveTypeCubicBezier: return (curve.count - 1) / 3;
+    }
+    return 0;
+}
+
+static simd_float3 catmullRomTangent(const Curve3D *curve, int index)
+{
+    const simd_float3 *p = curve->points;
+    if (index == 0) { return p[1] - p[0]; }
+    if (index == curve->count - 1) { return p[index] - p[index - 1]; }
+    return (p[index + 1] - p[index - 1]) * 0.5;
+}
+
+// hermite3 takes its tangents around the points: m0, a, b, m1
+static CurveSegment hermiteCurveSegment(simd_float3 m0, simd_float3 a, simd_float3 b,
+                                        simd_float3 m1)
+{
+    return (CurveSegment) { .type = CurveTypeHermite, .p0 = m0, .p1 = a, .p2 = b, .p3 = m1 };
+}
+
+// a point that doesn't move, used by curves without a segment
+static CurveSegment constantCurveSegment(simd_float3 p)
+{
+    return (CurveSegment) { .type = CurveTypeQuadraticBezier, .p0 = p, .p1 = p, .p2 = p, .p3 = p };
+}
+
+static CurveSegment getCurveSegment(const Curve3D *curve, int segment)
+{
+    const simd_float3 *p = curve->points;
+    switch (curve->type) {
+        case CurveTypeHermite:
+            return hermiteCurveSegment(curve->tangents[segment], p[segment], p[segment + 1],
+                                       curve->tangents[segment + 1]);
+        case CurveTypeCatmullRom:
+            return hermiteCurveSegment(catmullRomTangent(curve, segment), p[segment],
+                                       p[segment + 1], catmullRomTangent(curve, segment + 1));
+        case CurveTypeQuadraticBezier: {
+            const simd_float3 *q = p + segment * 2;
+            return (CurveSegment) {
+                .type = CurveTypeQuadraticBezier, .p0 = q[0], .p1 = q[1], .p2 = q[2], .p3 = q[2]
+            };
+        }
+        case CurveTypeCubicBezier: {
+            const simd_float3 *q = p + segment * 3;
+            return (CurveSegment) {
+                .type = CurveTypeCubicBezier, .p0 = q[0], .p1 = q[1], .p2 = q[2], .p3 = q[3]
+            };
+        }
+    }
+    return constantCurveSegment(simd_make_float3(0.0));
+}
+
+static inline simd_float3 evaluateCurveSegment(const CurveSegment *s, float t)
+{
+    switch (s->type) {
+        case CurveTypeHermite: return hermite3(s->p0, s->p1, s->p2, s->p3, t);
+        case CurveTypeQuadraticBezier: return quadraticBezier3(s->p0, s->p1, s->p2, t);
+        default: return cubicBezier3(s->p0, s->p1, s->p2, s->p3, t);
+    }
+}
+
+static inline simd_float3 evaluateCurveSegmentVelocity(const CurveSegment *s, float t)
+{
+    switch (s->type) {
+        case CurveTypeHermite: return hermiteVelocity3(s->p0, s->p1, s->p2, s->p3, t);
+        case CurveTypeQuadraticBezier: return quadraticBezierVelocity3(s->p0, s->p1, s->p2, t);
+        default: return cubicBezierVelocity3(s->p0, s->p1, s->p2, s->p3, t);
+    }
+}
+
+static CurveCursor createCurveCursor(Curve3D curve)
+{
+    CurveCursor cursor = { .curve = curve, .segmentCount = getCurveSegmentCount(curve) };
+    cursor.segment = -1;
+    if (cursor.segmentCount == 0) {
+        const bool hasPoint = curve.count > 0 && curve.points != NULL;
+        cursor.segmentData =
+            constantCurveSegment(hasPoint ? curve.points[0] : simd_make_float3(0.0));
+    }
+    return cursor;
+}
+
+// Moves the cursor to the segment containing u and returns the local parameter
+static inline float seekCurveCursor(CurveCursor *cursor, float u)
+{
+    if (cursor->segmentCount == 0) { return 0.0; }
+    const int segment = std::min(std::max((int)floorf(u), 0), cursor->segmentCount - 1);
+    if (segment != cursor->segment) {
+        cursor->segment = segment;
+        cursor->segmentData = getCurveSegment(&cursor->curve, segment);
+    }
+    return simd_clamp(u - (float)segment, 0.0f, 1.0f);
+}
+
+simd_float3 evaluateCurve3(Curve3D curve, float u)
+{
+    CurveCursor cursor = createCurveCursor(curve);
+    const float t = seekCurveCursor(&cursor, u);
+    return evaluateCurveSegment(&cursor.segmentData, t);
+}
+
+simd_float3 evaluateCurveVelocity3(Curve3D curve, float u)
+{
+    CurveCursor cursor = createCurveCursor(curve);
+    const float t = seekCurveCursor(&cursor, u);
+    return evaluateCurveSegmentVelocity(&cursor.segmentData, t);
+}
+
+void evaluateCurvePositions(Curve3D curve, const float *params, int count, simd_float3 *positions)
+{
+    CurveCursor cursor = createCurveCursor(curve);
+    for (int i = 0; i < count; i++) {
+        const float t = seekCurveCursor(&cursor, params[i]);
+        positions[i] = evaluateCurveSegment(&cursor.segmentData, t);
+    }
+}
+
+/* Arc Length */
+
+// 5 point Gauss-Legendre quadrature of the speed over [t0, t1]
+static float integrateSpeed(const CurveSegment *segment, float t0, float t1)
+{
+    const float nodes[5] = { 0.0, -0.5384693101056831, 0.5384693101056831, -0.9061798459386640,
+                             0.9061798459386640 };
+    const float weights[5] = { 0.5688888888888889, 0.4786286704993665, 0.4786286704993665,
+                               0.2369268850561891, 0.2369268850561891 };
+
+    const float half = (t1 - t0) * 0.5;
+    const float mid = (t1 + t0) * 0.5;
+    float sum = 0.0;
+    for (int i = 0; i < 5; i++) {
+        const float t = mid + half * nodes[i];
+        sum += weights[i] * simd_length(evaluateCurveSegmentVelocity(segment, t));
+    }
+    return sum * half;
+}
+
+CurveLUT createCurveLUT(Curve3D curve, int samplesPerSegment)
+{
+    samplesPerSegment = std::max(samplesPerSegment, 1);
+    const int segmentCount = getCurveSegmentCount(curve);
+    const int count = segmentCount * samplesPerSegment + 1;
+    float *lengths = (float *)malloc(count * sizeof(float));
+
+    const float inc = 1.0 / (float)samplesPerSegment;
+    double length = 0.0;
+    lengths[0] = 0.0;
+    for (int segment = 0; segment < segmentCount; segment++) {
+        const CurveSegment segmentData = getCurveSegment(&curve, segment);
+        for (int i = 0; i < samplesPerSegment; i++) {
+            length += integrateSpeed(&segmentData, i * inc, (i + 1) * inc);
+            lengths[segment * samplesPerSegment + i + 1] = length;
+        }
+    }
+
+    return (CurveLUT) { .segmentCount = segmentCount,
+                        .samplesPerSegment = samplesPerSegment,
+                        .count = count,
+                        .lengths = lengths,
+                        .length = (float)length };
+}
+
+void freeCurveLUT(CurveLUT *lut)
+{
+    if (lut->lengths != NULL) { free(lut->lengths); }
+    lut->lengths = NULL;
+    lut->count = 0;
+    lut->segmentCount = 0;
+    lut->length = 0.0;
+}
+
+static inline float interpolateCurveLUT(const CurveLUT *lut, int index, float length)
+{
+    const float l0 = lut->lengths[index];
+    const float l1 = lut->lengths[index + 1];
+    const float f = l1 > l0 ? (length - l0) / (l1 - l0) : 0.0;
+    return ((float)index + simd_clamp(f, 0.0f, 1.0f)) / (float)lut->samplesPerSegment;
+}
+
+float getCurveParameterAtLength(const CurveLUT *lut, float length)
+{
+    if (lut->count < 2) { return 0.0; }
+    if (length <= 0.0) { return 0.0; }
+    if (length >= lut->length) { return (float)lut->segmentCount; }
+
+    const float *upper = std::upper_bound(lut->lengths, lut->lengths + lut->count, length);
+    const int index = std::min((int)(upper - lut->lengths) - 1, lut->count - 2);
+    return interpolateCurveLUT(lut, index, length);
+}
+
+void sampleCurveByLength(Curve3D curve, const CurveLUT *lut, int count, float *params,
+                         simd_float3 *positions)
+{
+    CurveCursor cursor = createCurveCursor(curve);
+    const float inc = count > 1 ? lut->length / (float)(count - 1) : 0.0;
+
+    // targets are increasing so the table is walked once
+    int index = 0;
+    for (int i = 0; i < count; i++) {
+        float u = 0.0;
+        if (lut->count > 1) {
+            const float target = i == count - 1 ? lut->length : i * inc;
+            while (index < lut->count - 2 && lut->lengths[index + 1] < target) {
+                index++;
+            }
+            u = interpolateCurveLUT(lut, index, target);
+        }
+
+        if (params != NULL) { params[i] = u; }
+        if (positions != NULL) {
+            const float t = seekCurveCursor(&cursor, u);
+            positions[i] = evaluateCurveSegment(&cursor.segmentData, t);
+        }
+    }
+}
+
+/* Frames */
+
+static inline simd_float3 safeNormalize(simd_float3 v, simd_float3 fallback)
+{
+    const float len2 = simd_length_squared(v);
+    return len2 > 1e-20 ? v * simd_rsqrt(len2) : fallback;
+}
+
+static simd_float3 initialCurveNormal(simd_float3 tangent)
+{
+    const simd_float3 t = simd_abs(tangent);
+    simd_float3 axis = simd_make_float3(1.0, 0.0, 0.0);
+    if (t.y <= t.x && t.y <= t.z) { axis = simd_make_float3(0.0, 1.0, 0.0); }
+    else if (t.z <= t.x && t.z <= t.y) {
+        axis = simd_make_float3(0.0, 0.0, 1.0);
+    }
+    return simd_normalize(simd_cross(simd_cross(tangent, axis), tangent));
+}
+
+static void setInitialCurveFrame(CurveFrame *frame)
+{
+    frame->normal = initialCurveNormal(frame->tangent);
+    frame->binormal = simd_cross(frame->tangent, frame->normal);
+}
+
+// Double reflection (Wang et al. 2008), next needs its position and tangent set
+static void transportCurveFrame(const CurveFrame *prev, CurveFrame *next)
+{
+    const simd_float3 v1 = next->position - prev->position;
+    const float c1 = simd_dot(v1, v1);
+    simd_float3 normal = prev->normal;
+    simd_float3 tangent = prev->tangent;
+    if (c1 > 1e-20) {
+        normal -= (2.0 / c1) * simd_dot(v1, normal) * v1;
+        tangent -= (2.0 / c1) * simd_dot(v1, tangent) * v1;
+    }
+
+    const simd_float3 v2 = next->tangent - tangent;
+    const float c2 = simd_dot(v2, v2);
+    if (c2 > 1e-20) { normal -= (2.0 / c2) * simd_dot(v2, normal) * v2; }
+
+    // re-orthogonalize so error doesn't build up along long curves
+    normal = normal - simd_dot(normal, next->tangent) * next->tangent;
+    next->normal = safeNormalize(normal, initialCurveNormal(next->tangent));
+    next->binormal = simd_cross(next->tangent, next->normal);
+}
+
+static inline void evaluateCurveFrame(CurveCursor *cursor, float u, simd_float3 fallbackTangent,
+                                      CurveFrame *frame)
+{
+    const float t = seekCurveCursor(cursor, u);
+    frame->position = evaluateCurveSegment(&cursor->segmentData, t);
+    frame->tangent =
+        safeNormalize(evaluateCurveSegmentVelocity(&cursor->segmentData, t), fallbackTangent);
+}
+
+void computeCurveFrames(Curve3D curve, const float *params, int count, CurveFrame *frames)
+{
+    CurveCursor cursor = createCurveCursor(curve);
+    for (int i = 0; i < count; i++) {
+        const simd_float3 fallback =
+            i > 0 ? frames[i - 1].tangent : simd_make_float3(0.0, 0.0, 1.0);
+        evaluateCurveFrame(&cursor, params[i], fallback, &frames[i]);
+        if (i == 0) { setInitialCurveFrame(&frames[i]); }
+        else {
+            transportCurveFrame(&frames[i - 1], &frames[i]);
+        }
+    }
+}
+
+/* Sweep */
+
+static inline float tangentAngle(simd_float3 a, simd_float3 b)
+{
+    return acosf(simd_clamp(simd_dot(a, b), -1.0f, 1.0f));
+}
+
+static inline simd_float2 safeNormalize2(simd_float2 v)
+{
+    const float len2 = simd_length_squared(v);
+    return len2 > 1e-20 ? v * simd_rsqrt(len2) : simd_make_float2(0.0, 0.0);
+}
+
+// about 0.06 degrees
+static const float SweepMinAngleLimit = 0.001;
+static const int SweepMaxRings = 1 << 16;
+
+GeometryData generateSweepGeometryData(Curve3D curve, const CurveLUT *lut,
+                                       const simd_float2 *profile, int profileCount, bool closed,
+                                       float angleLimit, float maxSegmentLength)
+{
+    GeneratorProfileSpan span(__func__);
+    if (lut->count < 2 || profileCount < 2) { return span.finish(createGeometryData()); }
+
+    // tiny limits only add rings nobody can see, the clamps keep the ring count (and its int
+    // math) bounded no matter what's asked for
+    const float angleScale =
+        angleLimit > 0.0 ? 1.0 / std::max(angleLimit, SweepMinAngleLimit) : 0.0;
+    const float lengthScale =
+        maxSegmentLength > 0.0
+            ? std::min(1.0f / maxSegmentLength, (float)SweepMaxRings / std::max(lut->length, 1e-6f))
+            : 0.0;
+    const float paramInc = 1.0 / (float)lut->samplesPerSegment;
+
+    // Every LUT interval costs max(turn / angleLimit, length / maxSegmentLength), rings are spread
+    // evenly over the total cost, the walk is done twice so nothing is stored per sample
+    CurveCursor cursor = createCurveCursor(curve);
+    CurveFrame frame;
+    evaluateCurveFrame(&cursor, 0.0, simd_make_float3(0.0, 0.0, 1.0), &frame);
+    simd_float3 prevTangent = frame.tangent;
+    double totalCost = 0.0;
+    for (int k = 1; k < lut->count; k++) {
+        evaluateCurveFrame(&cursor, k * paramInc, prevTangent, &frame);
+        totalCost += std::max(tangentAngle(prevTangent, frame.tangent) * angleScale,
+                              (lut->lengths[k] - lut->lengths[k - 1]) * lengthScale);
+        prevTangent = frame.tangent;
+    }
+
+    const int columns = profileCount + (closed ? 1 : 0);
+    const double ringLimit = std::min((double)SweepMaxRings, (double)INT_MAX / (2.0 * columns));
+    const int rings = (int)std::min(std::max(ceil(totalCost), 1.0), ringLimit - 1.0) + 1;
+    const int vertexCount = rings * columns;
+    const int triangleCount = (rings - 1) * (columns - 1) * 2;
+
+    // profile normal (xy) and u coordinate (z) per column
+    simd_float3 *columnData = (simd_float3 *)malloc(columns * sizeof(simd_float3));
+    float profileLength = 0.0;
+    for (int j = 0; j < columns; j++) {
+        const int index = j % profileCount;
+        const int prev = closed ? (index + profileCount - 1) % profileCount : std::max(j - 1, 0);
+        const int next =
+            closed ? (index + 1) % profileCount : std::min(j + 1, profileCount - 1);
+        const simd_float2 dir = safeNormalize2(safeNormalize2(profile[index] - profile[prev]) +
+                                               safeNormalize2(profile[next] - profile[index]));
+        if (j > 0) {
+            profileLength += simd_length(profile[index] - profile[(j - 1) % profileCount]);
+        }
+        columnData[j] = simd_make_float3(dir.y, -dir.x, profileLength);
+    }
+    const float profileScale = profileLength > 0.0 ? 1.0 / profileLength : 0.0;
+    const float lengthInv = lut->length > 0.0 ? 1.0 / lut->length : 0.0;
+
+    Vertex *vtx = (Vertex *)malloc(vertexCount * sizeof(Vertex));
+    TriangleIndices *ind = (TriangleIndices *)malloc(triangleCount * sizeof(TriangleIndices));
+
+    int ring = 0;
+    auto emitRing = [&](float u, float length) {
+        CurveFrame next;
+        evaluateCurveFrame(&cursor, u, ring > 0 ? frame.tangent : simd_make_float3(0.0, 0.0, 1.0),
+                           &next);
+        if (ring == 0) { setInitialCurveFrame(&next); }
+        else {
+            transportCurveFrame(&frame, &next);
+        }
+        frame = next;
+
+        const float v = length * lengthInv;
+        Vertex *row = vtx + ring * columns;
+        for (int j = 0; j < columns; j++) {
+            const simd_float2 p = profile[j % profileCount];
+            const simd_float3 n = columnData[j];
+            row[j] = (Vertex) {
+                .position = simd_make_float4(frame.position + frame.normal * p.x +
+                                                 frame.binormal * p.y,
+                                             1.0),
+                .normal = frame.normal * n.x + frame.binormal * n.y,
+                .uv = simd_make_float2(n.z * profileScale, v)
+            };
+        }
+        ring++;
+    };
+
+    emitRing(0.0, 0.0);
+
+    const double costPerRing = totalCost / (double)(rings - 1);
+    double cost = 0.0;
+    prevTangent = frame.tangent;
+    for (int k = 1; k < lut->count && ring < rings - 1; k++) {
+        CurveFrame sample;
+        evaluateCurveFrame(&cursor, k * paramInc, prevTangent, &sample);
+        const float l0 = lut->lengths[k - 1];
+        const float l1 = lut->lengths[k];
+        const double intervalCost = std::max(tangentAngle(prevTangent, sample.tangent) * angleScale,
+                                             (l1 - l0) * lengthScale);
+        prevTangent = sample.tangent;
+
+        while (ring < rings - 1 && ring * costPerRing <= cost + intervalCost) {
+            const float f = intervalCost > 0.0 ? (ring * costPerRing - cost) / intervalCost : 1.0;
+            emitRing((k - 1 + f) * paramInc, l0 + f * (l1 - l0));
+        }
+        cost += intervalCost;
+    }
+    while (ring < rings) {
+        emitRing((float)lut->segmentCount, lut->length);
+    }
+    free(columnData);
+
+    int triangleIndex = 0;
+    for (int r = 0; r < rings - 1; r++) {
+        for (int j = 0; j < columns - 1; j++) {
+            const uint32_t a = r * columns + j;
+            const uint32_t b = a + 1;
+            const uint32_t c = a + columns;
+            const uint32_t d = c + 1;
+            ind[triangleIndex++] = (TriangleIndices) { .i0 = a, .i1 = b, .i2 = c };
+            ind[triangleIndex++] = (TriangleIndices) { .i0 = b, .i1 = d, .i2 = c };
+        }
+    }
+
+    return span.finish((GeometryData) {
+        .vertexCount = vertexCount, .vertexData = vtx, .indexCount = triangleCount, .indexData = ind
+    });
+}
+
+GeometryData generateCurveTubeGeometryData(Curve3D curve, const CurveLUT *lut, float radius,
+                                           int angularResolution, float angleLimit,
+                                           float maxSegmentLength)
+{
+    GeneratorProfileSpan span(__func__);
+    angularResolution = std::max(angularResolution, 3);
+    simd_float2 *profile = (simd_float2 *)malloc(angularResolution * sizeof(simd_float2));
+    for (int i = 0; i < angularResolution; i++) {
+        const float angle = 2.0 * M_PI * (float)i / (float)angularResolution;
+        profile[i] = radius * simd_make_float2(cosf(angle), sinf(angle));
+    }
+
+    GeometryData geometry = generateSweepGeometryData(curve, lut, profile, angularResolution, true,
+                                                      angleLimit, maxSegmentLength);
+    free(profile);
+    return span.finish(geometry);
+}
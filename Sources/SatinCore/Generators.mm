@@ -5,17 +5,23 @@
 //  Created by Reza Ali on 6/5/20.
 //
 
+#include <algorithm>
 #include <malloc/_malloc.h>
 #include <simd/simd.h>
+#include <vector>
 
 #include "Generators.h"
+#include "Bounds.h"
+#include "Bvh.h"
 #include "Geometry.h"
 #include "Conversions.h"
 #include "Transforms.h"
+#include "Profiler.h"
 
 GeometryData generateBoxGeometryData(float width, float height, float depth, float centerX,
                                      float centerY, float centerZ, int widthResolution,
                                      int heightResolution, int depthResolution) {
+    GeneratorProfileSpan profile(__func__);
     const int resWidth = widthResolution > 0 ? widthResolution : 1;
     const int resHeight = heightResolution > 0 ? heightResolution : 1;
     const int resDepth = depthResolution > 0 ? depthResolution : 1;
@@ -54,8 +60,8 @@ GeometryData generateBoxGeometryData(float width, float height, float depth, flo
         (trianglesPerFaceWidthHeight + trianglesPerFaceWidthDepth + trianglesPerFaceDepthHeight) *
         2;
 
-    Vertex *vtx = (Vertex *)malloc(vertices * sizeof(Vertex));
-    TriangleIndices *ind = (TriangleIndices *)malloc(triangles * sizeof(TriangleIndices));
+    Vertex *vtx = allocateVertexData(vertices);
+    TriangleIndices *ind = allocateIndexData(triangles);
 
     int vertexIndex = 0;
     int triangleIndex = 0;
@@ -207,13 +213,14 @@ GeometryData generateBoxGeometryData(float width, float height, float depth, flo
         }
     }
 
-    return (GeometryData) {
+    return profile.finish((GeometryData) {
         .vertexCount = vertices, .vertexData = vtx, .indexCount = triangles, .indexData = ind
-    };
+    });
 }
 
 GeometryData generateCylinderWallGeometryData(float radius, float height, int angularResolution,
                                               int verticalResolution) {
+    GeneratorProfileSpan profile(__func__);
     const int vertical = verticalResolution > 0 ? verticalResolution : 1;
     const int angular = angularResolution > 2 ? angularResolution : 3;
 
@@ -229,8 +236,8 @@ GeometryData generateCylinderWallGeometryData(float radius, float height, int an
     const int vertices = perLoop * (vertical + 1);
     const int triangles = angular * 2 * vertical;
 
-    Vertex *vtx = (Vertex *)malloc(vertices * sizeof(Vertex));
-    TriangleIndices *ind = (TriangleIndices *)malloc(triangles * sizeof(TriangleIndices));
+    Vertex *vtx = allocateVertexData(vertices);
+    TriangleIndices *ind = allocateIndexData(triangles);
 
     int vertexIndex = 0;
     int triangleIndex = 0;
@@ -264,13 +271,14 @@ GeometryData generateCylinderWallGeometryData(float radius, float height, int an
         }
     }
 
-    return (GeometryData) {
+    return profile.finish((GeometryData) {
         .vertexCount = vertices, .vertexData = vtx, .indexCount = triangles, .indexData = ind
-    };
+    });
 }
 
 GeometryData generateCapsuleGeometryData(float radius, float height, int angularResolution,
                                          int radialResolution, int verticalResolution, int axis) {
+    GeneratorProfileSpan profile(__func__);
     const int phi = angularResolution > 2 ? angularResolution : 3;
     const int theta = radialResolution > 0 ? radialResolution : 1;
     const int slices = verticalResolution > 0 ? verticalResolution : 1;
@@ -302,8 +310,8 @@ GeometryData generateCapsuleGeometryData(float radius, float height, int angular
     const int vertices = verticesPerCap * 2 + verticesPerSide;
     const int triangles = trianglesPerCap * 2 + trianglesPerSide;
 
-    Vertex *vtx = (Vertex *)malloc(vertices * sizeof(Vertex));
-    TriangleIndices *ind = (TriangleIndices *)malloc(triangles * sizeof(TriangleIndices));
+    Vertex *vtx = allocateVertexData(vertices);
+    TriangleIndices *ind = allocateIndexData(triangles);
 
     int vertexIndex = 0;
     int triangleIndex = 0;
@@ -460,13 +468,14 @@ GeometryData generateCapsuleGeometryData(float radius, float height, int angular
         }
     }
 
-    return (GeometryData) {
+    return profile.finish((GeometryData) {
         .vertexCount = vertices, .vertexData = vtx, .indexCount = triangles, .indexData = ind
-    };
+    });
 }
 
 GeometryData generateConeGeometryData(float radius, float height, int angularResolution,
                                       int radialResolution, int verticalResolution) {
+    GeneratorProfileSpan profile(__func__);
     const int vertical = verticalResolution > 0 ? verticalResolution : 1;
     const int angular = angularResolution > 2 ? angularResolution : 3;
     const int radial = radialResolution > 0 ? radialResolution : 1;
@@ -492,8 +501,8 @@ GeometryData generateConeGeometryData(float radius, float height, int angularRes
     const int vertices = verticesPerWall + verticesPerCircle;
     const int triangles = trianglesPerWall + trianglesPerCircle;
 
-    Vertex *vtx = (Vertex *)malloc(vertices * sizeof(Vertex));
-    TriangleIndices *ind = (TriangleIndices *)malloc(triangles * sizeof(TriangleIndices));
+    Vertex *vtx = allocateVertexData(vertices);
+    TriangleIndices *ind = allocateIndexData(triangles);
 
     int vertexIndex = 0;
     int triangleIndex = 0;
@@ -572,13 +581,14 @@ GeometryData generateConeGeometryData(float radius, float height, int angularRes
         }
     }
 
-    return (GeometryData) {
+    return profile.finish((GeometryData) {
         .vertexCount = vertices, .vertexData = vtx, .indexCount = triangles, .indexData = ind
-    };
+    });
 }
 
 GeometryData generateCylinderGeometryData(float radius, float height, int angularResolution,
                                           int radialResolution, int verticalResolution) {
+    GeneratorProfileSpan profile(__func__);
 
     const int radial = radialResolution > 0 ? radialResolution : 1;
     const int angular = angularResolution > 2 ? angularResolution : 3;
@@ -654,7 +664,7 @@ GeometryData generateCylinderGeometryData(float radius, float height, int angula
     geometry.vertexCount = vertices;
     geometry.indexCount = triangles;
 
-    return geometry;
+    return profile.finish(geometry);
 }
 
 enum PlaneOrientation {
@@ -666,11 +676,96 @@ enum PlaneOrientation {
     zy = 5  // points in -x direction
 };
 
+// Orients a point of the xy plane, flip is set when the plane's winding has to be reversed
+static inline Vertex makePlaneVertex(float xP, float yP, float xuv, float yuv, int plane,
+                                     bool *flip)
+{
+    simd_float4 position = simd_make_float4(xP, yP, 0.0, 1.0);
+    simd_float3 normal = simd_make_float3(0.0, 0.0, 1.0);
+    simd_float2 uv = simd_make_float2(xuv, yuv);
+
+    *flip = false;
+    switch (plane) {
+        case yx: // points in -z direction
+            normal = simd_make_float3(0.0, 0.0, -1.0);
+            uv.x = 1.0 - uv.x;
+            *flip = true;
+            break;
+        case xz: // points in -y direction
+            position = simd_make_float4(xP, 0.0, yP, 1.0);
+            normal = simd_make_float3(0.0, -1.0, 0.0);
+            break;
+        case zx: // points in +y direction
+            position = simd_make_float4(xP, 0.0, yP, 1.0);
+            normal = simd_make_float3(0.0, 1.0, 0.0);
+            uv.y = 1.0 - uv.y;
+            *flip = true;
+            break;
+        case yz: // points in +x direction
+            position = simd_make_float4(0.0, xP, yP, 1.0);
+            normal = simd_make_float3(1.0, 0.0, 0.0);
+            uv.x = 1.0 - yuv;
+            uv.y = xuv;
+            break;
+        case zy: // points in -x direction
+            position = simd_make_float4(0.0, xP, yP, 1.0);
+            normal = simd_make_float3(-1.0, 0.0, 0.0);
+            uv.x = yuv;
+            uv.y = xuv;
+            *flip = true;
+            break;
+        default: break;
+    }
+
+    return (Vertex) { .position = position, .normal = normal, .uv = uv };
+}
+
+static inline void addGridCellTriangles(TriangleIndices *ind, int *triangleIndex, uint32_t index,
+                                        uint32_t perRow, bool flip)
+{
+    const uint32_t bl = index;
+    const uint32_t br = bl + 1;
+    const uint32_t tl = index + perRow;
+    const uint32_t tr = tl + 1;
+
+    if (flip) {
+        ind[(*triangleIndex)++] = (TriangleIndices) { .i0 = bl, .i1 = tl, .i2 = br };
+        ind[(*triangleIndex)++] = (TriangleIndices) { .i0 = br, .i1 = tl, .i2 = tr };
+    } else {
+        ind[(*triangleIndex)++] = (TriangleIndices) { .i0 = bl, .i1 = br, .i2 = tl };
+        ind[(*triangleIndex)++] = (TriangleIndices) { .i0 = br, .i1 = tr, .i2 = tl };
+    }
+}
+
+bool getGridGeometrySize(int64_t columns, int64_t rows, int *vertexCount, int *triangleCount)
+{
+    *vertexCount = 0;
+    *triangleCount = 0;
+    if (columns <= 0 || rows <= 0 || columns > INT32_MAX || rows > INT32_MAX) { return false; }
+
+    // both fit in 64 bits once each side fits in 32
+    const int64_t vertices = (columns + 1) * (rows + 1);
+    const int64_t triangles = columns * rows * 2;
+    if (vertices > INT32_MAX || triangles > INT32_MAX) { return false; }
+
+    *vertexCount = (int)vertices;
+    *triangleCount = (int)triangles;
+    return true;
+}
+
 GeometryData generatePlaneGeometryData(float width, float height, int widthResolution,
                                        int heightResolution, int plane, bool centered) {
+    GeneratorProfileSpan profile(__func__);
     const int resWidth = widthResolution > 0 ? widthResolution : 1;
     const int resHeight = heightResolution > 0 ? heightResolution : 1;
 
+    // grids this large have to be generated in tiles
+    int vertices = 0;
+    int triangles = 0;
+    if (!getGridGeometrySize(resWidth, resHeight, &vertices, &triangles)) {
+        return profile.finish(createGeometryData());
+    }
+
     const float resWidthf = (float)resWidth;
     const float resHeightf = (float)resHeight;
 
@@ -684,11 +779,9 @@ GeometryData generatePlaneGeometryData(float width, float height, int widthResol
     const float centerYOffset = centered ? -halfHeight : 0.0;
 
     const int perRow = resWidth + 1;
-    const int vertices = (resHeight + 1) * perRow;
-    const int triangles = resWidth * 2 * resHeight;
 
-    Vertex *vtx = (Vertex *)malloc(vertices * sizeof(Vertex));
-    TriangleIndices *ind = (TriangleIndices *)malloc(triangles * sizeof(TriangleIndices));
+    Vertex *vtx = allocateVertexData(vertices);
+    TriangleIndices *ind = allocateIndexData(triangles);
 
     int vertexIndex = 0;
     int triangleIndex = 0;
@@ -704,70 +797,193 @@ GeometryData generatePlaneGeometryData(float width, float height, int widthResol
             const float xP = centerXOffset + xf * widthInc;
             const float yP = centerYOffset + yf * heightInc;
 
-            simd_float4 position = simd_make_float4(xP, yP, 0.0, 1.0);
-            simd_float3 normal = simd_make_float3(0.0, 0.0, 1.0);
-            simd_float2 uv = simd_make_float2(xuv, yuv);
-
             bool flip = false;
-            switch (plane) {
-                case yx: // points in -z direction
-                    normal = simd_make_float3(0.0, 0.0, -1.0);
-                    uv.x = 1.0 - uv.x;
-                    flip = true;
-                    break;
-                case xz: // points in -y direction
-                    position = simd_make_float4(xP, 0.0, yP, 1.0);
-                    normal = simd_make_float3(0.0, -1.0, 0.0);
-                    break;
-                case zx: // points in +y direction
-                    position = simd_make_float4(xP, 0.0, yP, 1.0);
-                    normal = simd_make_float3(0.0, 1.0, 0.0);
-                    uv.y = 1.0 - uv.y;
-                    flip = true;
-                    break;
-                case yz: // points in +x direction
-                    position = simd_make_float4(0.0, xP, yP, 1.0);
-                    normal = simd_make_float3(1.0, 0.0, 0.0);
-                    uv.x = 1.0 - yuv;
-                    uv.y = xuv;
-                    break;
-                case zy: // points in -x direction
-                    position = simd_make_float4(0.0, xP, yP, 1.0);
-                    normal = simd_make_float3(-1.0, 0.0, 0.0);
-                    uv.x = yuv;
-                    uv.y = xuv;
-                    flip = true;
-                    break;
-                default: break;
+            vtx[vertexIndex++] = makePlaneVertex(xP, yP, xuv, yuv, plane, &flip);
+
+            if (x != resWidth && y != resHeight) {
+                addGridCellTriangles(ind, &triangleIndex, x + y * perRow, perRow, flip);
             }
+        }
+    }
 
-            vtx[vertexIndex++] = (Vertex) { .position = position, .normal = normal, .uv = uv };
+    return profile.finish((GeometryData) {
+        .vertexCount = vertices, .vertexData = vtx, .indexCount = triangles, .indexData = ind
+    });
+}
 
-            if (x != resWidth && y != resHeight) {
-                const uint32_t index = x + y * perRow;
-                const uint32_t bl = index;
-                const uint32_t br = bl + 1;
-                const uint32_t tl = index + perRow;
-                const uint32_t tr = tl + 1;
+// Tiles are capped so their vertex count stays well inside 32 bit indices
+#define MAX_GRID_TILE_RESOLUTION 2048
+
+static int getGridTileResolution(const GridTileParameters *parameters)
+{
+    const int resolution = parameters->tileResolution;
+    if (resolution < 1) { return 1; }
+    return resolution > MAX_GRID_TILE_RESOLUTION ? MAX_GRID_TILE_RESOLUTION : resolution;
+}
 
-                if (flip) {
-                    ind[triangleIndex++] = (TriangleIndices) { .i0 = bl, .i1 = tl, .i2 = br };
-                    ind[triangleIndex++] = (TriangleIndices) { .i0 = br, .i1 = tl, .i2 = tr };
-                } else {
-                    ind[triangleIndex++] = (TriangleIndices) { .i0 = bl, .i1 = br, .i2 = tl };
-                    ind[triangleIndex++] = (TriangleIndices) { .i0 = br, .i1 = tr, .i2 = tl };
+void getGridTileCounts(const GridTileParameters *parameters, int *columns, int *rows)
+{
+    const int64_t tileResolution = getGridTileResolution(parameters);
+    const int64_t resWidth = parameters->widthResolution > 0 ? parameters->widthResolution : 1;
+    const int64_t resHeight = parameters->heightResolution > 0 ? parameters->heightResolution : 1;
+    *columns = (int)((resWidth + tileResolution - 1) / tileResolution);
+    *rows = (int)((resHeight + tileResolution - 1) / tileResolution);
+}
+
+// Global grid point, evaluated the same way by every tile so shared borders match exactly
+static inline Vertex makeGridVertex(const GridTileParameters *parameters, int x, int y,
+                                    bool *flip)
+{
+    const int resWidth = parameters->widthResolution > 0 ? parameters->widthResolution : 1;
+    const int resHeight = parameters->heightResolution > 0 ? parameters->heightResolution : 1;
+
+    const float xf = (float)x;
+    const float yf = (float)y;
+    const float xuv = xf / (float)resWidth;
+    const float yuv = yf / (float)resHeight;
+
+    const float xOffset = parameters->centered ? -parameters->width * 0.5 : 0.0;
+    const float yOffset = parameters->centered ? -parameters->height * 0.5 : 0.0;
+    const float xP = xOffset + xf * (parameters->width / (float)resWidth);
+    const float yP = yOffset + yf * (parameters->height / (float)resHeight);
+
+    Vertex vertex = makePlaneVertex(xP, yP, xuv, yuv, parameters->plane, flip);
+    if (parameters->heightFunction != NULL) {
+        const float h = parameters->heightFunction(simd_make_float2(xuv, yuv),
+                                                   parameters->heightContext);
+        vertex.position += simd_make_float4(vertex.normal * h, 0.0);
+    }
+    return vertex;
+}
+
+GeometryTile generateGridTile(const GridTileParameters *parameters, int tileX, int tileY)
+{
+    GeneratorProfileSpan profile(__func__);
+
+    GeometryTile tile = { .tileX = tileX,
+                          .tileY = tileY,
+                          .column = 0,
+                          .row = 0,
+                          .columns = 0,
+                          .rows = 0,
+                          .bounds = createBounds(),
+                          .geometry = createGeometryData(),
+                          .bvh = {} };
+
+    int tileColumns = 0;
+    int tileRows = 0;
+    getGridTileCounts(parameters, &tileColumns, &tileRows);
+    if (tileX < 0 || tileY < 0 || tileX >= tileColumns || tileY >= tileRows) {
+        profile.finish(tile.geometry);
+        return tile;
+    }
+
+    const int resWidth = parameters->widthResolution > 0 ? parameters->widthResolution : 1;
+    const int resHeight = parameters->heightResolution > 0 ? parameters->heightResolution : 1;
+    const int tileResolution = getGridTileResolution(parameters);
+
+    tile.column = tileX * tileResolution;
+    tile.row = tileY * tileResolution;
+    tile.columns = std::min(tileResolution, resWidth - tile.column);
+    tile.rows = std::min(tileResolution, resHeight - tile.row);
+
+    int vertices = 0;
+    int triangles = 0;
+    getGridGeometrySize(tile.columns, tile.rows, &vertices, &triangles);
+
+    Vertex *vtx = allocateVertexData(vertices);
+    TriangleIndices *ind = allocateIndexData(triangles);
+
+    // with a height function the tile's grid points and a one point halo from the neighbouring
+    // tiles are evaluated once, displaced normals come from the halo so lighting doesn't seam at
+    // tile borders
+    const bool displaced = parameters->heightFunction != NULL;
+    const int stride = tile.columns + 3;
+    std::vector<Vertex> halo;
+    bool flip = false;
+    if (displaced) {
+        halo.resize(stride * (tile.rows + 3));
+        for (int y = -1; y <= tile.rows + 1; y++) {
+            const int gy = std::min(std::max(tile.row + y, 0), resHeight);
+            for (int x = -1; x <= tile.columns + 1; x++) {
+                const int gx = std::min(std::max(tile.column + x, 0), resWidth);
+                halo[(y + 1) * stride + x + 1] = makeGridVertex(parameters, gx, gy, &flip);
+            }
+        }
+    }
+
+    const int perRow = tile.columns + 1;
+    int vertexIndex = 0;
+    int triangleIndex = 0;
+
+    for (int y = 0; y <= tile.rows; y++) {
+        for (int x = 0; x <= tile.columns; x++) {
+            Vertex vertex;
+            if (displaced) {
+                const int center = (y + 1) * stride + x + 1;
+                vertex = halo[center];
+                const simd_float3 dx = simd_make_float3(halo[center + 1].position) -
+                                       simd_make_float3(halo[center - 1].position);
+                const simd_float3 dy = simd_make_float3(halo[center + stride].position) -
+                                       simd_make_float3(halo[center - stride].position);
+                const simd_float3 normal = simd_cross(dx, dy);
+                const float length = simd_length(normal);
+                if (length > 0.0) {
+                    const bool facing = simd_dot(normal, vertex.normal) >= 0.0;
+                    vertex.normal = (facing ? normal : -normal) / length;
                 }
+            } else {
+                vertex = makeGridVertex(parameters, tile.column + x, tile.row + y, &flip);
+            }
+            vtx[vertexIndex++] = vertex;
+
+            if (x != tile.columns && y != tile.rows) {
+                addGridCellTriangles(ind, &triangleIndex, x + y * perRow, perRow, flip);
             }
         }
     }
 
-    return (GeometryData) {
+    for (int i = 0; i < vertices; i++) {
+        tile.bounds = expandBounds(tile.bounds, simd_make_float3(vtx[i].position));
+    }
+
+    tile.geometry = (GeometryData) {
         .vertexCount = vertices, .vertexData = vtx, .indexCount = triangles, .indexData = ind
     };
+    if (parameters->buildBVH) { tile.bvh = createBVH(tile.geometry, parameters->useSAH); }
+
+    profile.finish(tile.geometry);
+    return tile;
+}
+
+void freeGeometryTile(GeometryTile *tile)
+{
+    // the BVH reads the tile's geometry in place
+    if (tile->bvh.nodes != NULL) { freeBVH(tile->bvh); }
+    tile->bvh = (BVH) {};
+    freeGeometryData(&tile->geometry);
+}
+
+int64_t generateGridTiles(const GridTileParameters *parameters, GeometryTileCallback callback,
+                          void *context)
+{
+    int columns = 0;
+    int rows = 0;
+    getGridTileCounts(parameters, &columns, &rows);
+
+    for (int y = 0; y < rows; y++) {
+        for (int x = 0; x < columns; x++) {
+            GeometryTile tile = generateGridTile(parameters, x, y);
+            callback(&tile, context);
+            freeGeometryTile(&tile);
+        }
+    }
+    return (int64_t)columns * rows;
 }
 
 GeometryData generateArcGeometryData(float innerRadius, float outerRadius, float startAngle,
                                      float endAngle, int angularResolution, int radialResolution) {
+    GeneratorProfileSpan profile(__func__);
     const int radial = radialResolution > 0 ? radialResolution : 1;
     const int angular = angularResolution > 2 ? angularResolution : 3;
 
@@ -781,8 +997,8 @@ GeometryData generateArcGeometryData(float innerRadius, float outerRadius, float
     const int vertices = (radial + 1) * perArc;
     const int triangles = angular * 2 * radial;
 
-    Vertex *vtx = (Vertex *)malloc(vertices * sizeof(Vertex));
-    TriangleIndices *ind = (TriangleIndices *)malloc(triangles * sizeof(TriangleIndices));
+    Vertex *vtx = allocateVertexData(vertices);
+    TriangleIndices *ind = allocateIndexData(triangles);
 
     int vertexIndex = 0;
     int triangleIndex = 0;
@@ -815,13 +1031,14 @@ GeometryData generateArcGeometryData(float innerRadius, float outerRadius, float
         }
     }
 
-    return (GeometryData) {
+    return profile.finish((GeometryData) {
         .vertexCount = vertices, .vertexData = vtx, .indexCount = triangles, .indexData = ind
-    };
+    });
 }
 
 GeometryData generateTorusGeometryData(float minorRadius, float majorRadius, int minorResolution,
                                        int majorResolution) {
+    GeneratorProfileSpan profile(__func__);
     const int slices = minorResolution > 2 ? minorResolution : 3;
     const int angular = majorResolution > 2 ? majorResolution : 3;
 
@@ -836,8 +1053,8 @@ GeometryData generateTorusGeometryData(float minorRadius, float majorRadius, int
     const int vertices = (slices + 1) * perLoop;
     const int triangles = angular * 2 * slices;
 
-    Vertex *vtx = (Vertex *)malloc(vertices * sizeof(Vertex));
-    TriangleIndices *ind = (TriangleIndices *)malloc(triangles * sizeof(TriangleIndices));
+    Vertex *vtx = allocateVertexData(vertices);
+    TriangleIndices *ind = allocateIndexData(triangles);
 
     int vertexIndex = 0;
     int triangleIndex = 0;
@@ -884,19 +1101,20 @@ GeometryData generateTorusGeometryData(float minorRadius, float majorRadius, int
         }
     }
 
-    return (GeometryData) {
+    return profile.finish((GeometryData) {
         .vertexCount = vertices, .vertexData = vtx, .indexCount = triangles, .indexData = ind
-    };
+    });
 }
 
 GeometryData generateSkyboxGeometryData(float size) {
+    GeneratorProfileSpan profile(__func__);
     const float halfSize = size * 0.5;
 
     const int vertices = 24;
     const int triangles = 12;
 
-    Vertex *vtx = (Vertex *)malloc(vertices * sizeof(Vertex));
-    TriangleIndices *ind = (TriangleIndices *)malloc(triangles * sizeof(TriangleIndices));
+    Vertex *vtx = allocateVertexData(vertices);
+    TriangleIndices *ind = allocateIndexData(triangles);
 
     // +Y
     vtx[0] = (Vertex) { .position = simd_make_float4(-halfSize, halfSize, halfSize, 1.0),
@@ -990,12 +1208,13 @@ GeometryData generateSkyboxGeometryData(float size) {
     ind[10] = (TriangleIndices) { .i0 = 20, .i1 = 23, .i2 = 22 };
     ind[11] = (TriangleIndices) { .i0 = 22, .i1 = 21, .i2 = 20 };
 
-    return (GeometryData) {
+    return profile.finish((GeometryData) {
         .vertexCount = vertices, .vertexData = vtx, .indexCount = triangles, .indexData = ind
-    };
+    });
 }
 
 GeometryData generateCircleGeometryData(float radius, int angularResolution, int radialResolution) {
+    GeneratorProfileSpan profile(__func__);
     const int radial = radialResolution > 0 ? radialResolution : 1;
     const int angular = angularResolution > 2 ? angularResolution : 3;
 
@@ -1010,8 +1229,8 @@ GeometryData generateCircleGeometryData(float radius, int angularResolution, int
     const int vertices = perLoop * (radial + 1);
     const int triangles = angular * 2 * radial;
 
-    Vertex *vtx = (Vertex *)malloc(vertices * sizeof(Vertex));
-    TriangleIndices *ind = (TriangleIndices *)malloc(triangles * sizeof(TriangleIndices));
+    Vertex *vtx = allocateVertexData(vertices);
+    TriangleIndices *ind = allocateIndexData(triangles);
 
     int vertexIndex = 0;
     int triangleIndex = 0;
@@ -1043,17 +1262,18 @@ GeometryData generateCircleGeometryData(float radius, int angularResolution, int
         }
     }
 
-    return (GeometryData) {
+    return profile.finish((GeometryData) {
         .vertexCount = vertices, .vertexData = vtx, .indexCount = triangles, .indexData = ind
-    };
+    });
 }
 
 GeometryData generateTriangleGeometryData(float size) {
+    GeneratorProfileSpan profile(__func__);
     const int vertices = 3;
     const int triangles = 1;
 
-    Vertex *vtx = (Vertex *)malloc(vertices * sizeof(Vertex));
-    TriangleIndices *ind = (TriangleIndices *)malloc(triangles * sizeof(TriangleIndices));
+    Vertex *vtx = allocateVertexData(vertices);
+    TriangleIndices *ind = allocateIndexData(triangles);
 
     const float twoPi = M_PI * 2.0;
     float angle = 0.0;
@@ -1076,19 +1296,20 @@ GeometryData generateTriangleGeometryData(float size) {
 
     ind[0] = (TriangleIndices) { .i0 = 0, .i1 = 2, .i2 = 1 };
 
-    return (GeometryData) {
+    return profile.finish((GeometryData) {
         .vertexCount = vertices, .vertexData = vtx, .indexCount = triangles, .indexData = ind
-    };
+    });
 }
 
 GeometryData generateQuadGeometryData(float size) {
+    GeneratorProfileSpan profile(__func__);
     const float halfSize = size * 0.5;
 
     const int vertices = 4;
     const int triangles = 2;
 
-    Vertex *vtx = (Vertex *)malloc(vertices * sizeof(Vertex));
-    TriangleIndices *ind = (TriangleIndices *)malloc(triangles * sizeof(TriangleIndices));
+    Vertex *vtx = allocateVertexData(vertices);
+    TriangleIndices *ind = allocateIndexData(triangles);
 
     vtx[0] = (Vertex) { .position = simd_make_float4(-halfSize, -halfSize, 0.0, 1.0),
                         .normal = simd_make_float3(0.0, 0.0, 1.0),
@@ -1109,13 +1330,14 @@ GeometryData generateQuadGeometryData(float size) {
     ind[0] = (TriangleIndices) { .i0 = 0, .i1 = 1, .i2 = 2 };
     ind[1] = (TriangleIndices) { .i0 = 0, .i1 = 2, .i2 = 3 };
 
-    return (GeometryData) {
+    return profile.finish((GeometryData) {
         .vertexCount = vertices, .vertexData = vtx, .indexCount = triangles, .indexData = ind
-    };
+    });
 }
 
 GeometryData generateSphereGeometryData(float radius, int angularResolution,
                                         int verticalResolution) {
+    GeneratorProfileSpan profile(__func__);
     const int phi = angularResolution > 2 ? angularResolution : 3;
     const int layers = verticalResolution > 2 ? verticalResolution : 3;
 
@@ -1133,8 +1355,8 @@ GeometryData generateSphereGeometryData(float radius, int angularResolution,
     const int vertices = (layers + 1) * perLoop;
     const int triangles = layers * phi * 2;
 
-    Vertex *vtx = (Vertex *)malloc(vertices * sizeof(Vertex));
-    TriangleIndices *ind = (TriangleIndices *)malloc(triangles * sizeof(TriangleIndices));
+    Vertex *vtx = allocateVertexData(vertices);
+    TriangleIndices *ind = allocateIndexData(triangles);
 
     int vertexIndex = 0;
     int triangleIndex = 0;
@@ -1175,12 +1397,13 @@ GeometryData generateSphereGeometryData(float radius, int angularResolution,
         }
     }
 
-    return (GeometryData) {
+    return profile.finish((GeometryData) {
         .vertexCount = vertices, .vertexData = vtx, .indexCount = triangles, .indexData = ind
-    };
+    });
 }
 
 GeometryData generateIcoSphereGeometryData(float radius, int res) {
+    GeneratorProfileSpan profile(__func__);
     const float phi = (1.0 + sqrt(5)) * 0.5;
     const float r2 = radius * radius;
     const float den = (1.0 + (1.0 / pow(phi, 2.0)));
@@ -1190,8 +1413,8 @@ GeometryData generateIcoSphereGeometryData(float radius, int res) {
     int vertices = 12;
     int triangles = 20;
 
-    Vertex *vtx = (Vertex *)malloc(vertices * sizeof(Vertex));
-    TriangleIndices *ind = (TriangleIndices *)malloc(triangles * sizeof(TriangleIndices));
+    Vertex *vtx = allocateVertexData(vertices);
+    TriangleIndices *ind = allocateIndexData(triangles);
 
     vtx[0].position = simd_make_float4(0.0, h, w, 1.0);
     vtx[1].position = simd_make_float4(0.0, h, -w, 1.0);
@@ -1294,14 +1517,15 @@ GeometryData generateIcoSphereGeometryData(float radius, int res) {
         vtx[i].uv = simd_make_float2((atan2(n.x, n.z) + M_PI) / (2.0 * M_PI), acos(n.y) / M_PI);
     }
 
-    return (GeometryData) {
+    return profile.finish((GeometryData) {
         .vertexCount = vertices, .vertexData = vtx, .indexCount = triangles, .indexData = ind
-    };
+    });
 }
 
 // Referenced from: https://prideout.net/blog/octasphere/
 
 GeometryData generateOctaSphereGeometryData(float radius, int res) {
+    GeneratorProfileSpan profile(__func__);
     const int n = (1 << res) + 1;
     const float nf = (float)n;
 
@@ -1312,8 +1536,8 @@ GeometryData generateOctaSphereGeometryData(float radius, int res) {
     const int vertices = verticesPerPatch * patches;
     const int triangles = trianglesPerPatch * patches;
 
-    Vertex *vtx = (Vertex *)malloc(vertices * sizeof(Vertex));
-    TriangleIndices *ind = (TriangleIndices *)malloc(triangles * sizeof(TriangleIndices));
+    Vertex *vtx = allocateVertexData(vertices);
+    TriangleIndices *ind = allocateIndexData(triangles);
 
     const int nMinusOne = n - 1;
     const float nMinusOnef = nf - 1.0;
@@ -1380,7 +1604,7 @@ GeometryData generateOctaSphereGeometryData(float radius, int res) {
     };
 
     {
-        GeometryData copied;
+        GeometryData copied = createGeometryData();
         copyGeometryData(&copied, &geoData);
         transformGeometryData(
             &copied, simd_matrix4x4(simd_quaternion(M_PI_2, simd_make_float3(0.0, 1.0, 0.0))));
@@ -1389,7 +1613,7 @@ GeometryData generateOctaSphereGeometryData(float radius, int res) {
     }
 
     {
-        GeometryData copied;
+        GeometryData copied = createGeometryData();
         copyGeometryData(&copied, &geoData);
         transformGeometryData(
             &copied, simd_matrix4x4(simd_quaternion(M_PI, simd_make_float3(0.0, 1.0, 0.0))));
@@ -1398,7 +1622,7 @@ GeometryData generateOctaSphereGeometryData(float radius, int res) {
     }
 
     {
-        GeometryData copied;
+        GeometryData copied = createGeometryData();
         copyGeometryData(&copied, &geoData);
         transformGeometryData(
             &copied, simd_matrix4x4(simd_quaternion(M_PI, simd_make_float3(1.0, 0.0, 0.0))));
@@ -1414,11 +1638,12 @@ GeometryData generateOctaSphereGeometryData(float radius, int res) {
             simd_make_float2((atan2(n.x, n.z) + M_PI) / (2.0 * M_PI), acos(n.y) / M_PI);
     }
 
-    return geoData;
+    return profile.finish(geoData);
 }
 
 GeometryData generateSquircleGeometryData(float size, float p, int angularResolution,
                                           int radialResolution) {
+    GeneratorProfileSpan profile(__func__);
     const float rad = size * 0.5;
     const int angular = angularResolution > 2 ? angularResolution : 3;
     const int radial = radialResolution > 1 ? radialResolution : 1;
@@ -1427,8 +1652,8 @@ GeometryData generateSquircleGeometryData(float size, float p, int angularResolu
     const int vertices = perLoop * (radial + 1);
     const int triangles = angular * 2 * radial;
 
-    Vertex *vtx = (Vertex *)malloc(vertices * sizeof(Vertex));
-    TriangleIndices *ind = (TriangleIndices *)malloc(triangles * sizeof(TriangleIndices));
+    Vertex *vtx = allocateVertexData(vertices);
+    TriangleIndices *ind = allocateIndexData(triangles);
 
     int vertexIndex = 0;
     int triangleIndex = 0;
@@ -1468,14 +1693,15 @@ GeometryData generateSquircleGeometryData(float size, float p, int angularResolu
         }
     }
 
-    return (GeometryData) {
+    return profile.finish((GeometryData) {
         .vertexCount = vertices, .vertexData = vtx, .indexCount = triangles, .indexData = ind
-    };
+    });
 }
 
 GeometryData generateRoundedRectGeometryData(float width, float height, float radius,
                                              int angularResolution, int edgeXResolution,
                                              int edgeYResolution, int radialResolution) {
+    GeneratorProfileSpan profile(__func__);
     const float twoPi = M_PI * 2.0;
     const float halfPi = M_PI * 0.5;
 
@@ -1503,8 +1729,8 @@ GeometryData generateRoundedRectGeometryData(float width, float height, float ra
     const int vertices = perLoop * radial;
     const int triangles = perLoop * 2 * (radial - 1);
 
-    Vertex *vtx = (Vertex *)malloc(vertices * sizeof(Vertex));
-    TriangleIndices *ind = (TriangleIndices *)malloc(triangles * sizeof(TriangleIndices));
+    Vertex *vtx = allocateVertexData(vertices);
+    TriangleIndices *ind = allocateIndexData(triangles);
 
     const float widthHalf = width * 0.5;
     const float heightHalf = height * 0.5;
@@ -1691,15 +1917,16 @@ GeometryData generateRoundedRectGeometryData(float width, float height, float ra
         }
     }
 
-    return (GeometryData) {
+    return profile.finish((GeometryData) {
         .vertexCount = vertices, .vertexData = vtx, .indexCount = triangles, .indexData = ind
-    };
+    });
 }
 
 GeometryData generateExtrudedRoundedRectGeometryData(float width, float height, float depth,
                                                      float radius, int angularResolution,
                                                      int edgeXResolution, int edgeYResolution,
                                                      int edgeZResolution, int radialResolution) {
+    GeneratorProfileSpan profile(__func__);
     GeometryData faceData =
         generateRoundedRectGeometryData(width, height, radius, angularResolution, edgeXResolution,
                                         edgeYResolution, radialResolution);
@@ -1783,11 +2010,12 @@ GeometryData generateExtrudedRoundedRectGeometryData(float width, float height,
     freeGeometryData(&extrudeData);
     freeGeometryData(&faceData);
 
-    return result;
+    return profile.finish(result);
 }
 
 GeometryData generateTubeGeometryData(float radius, float height, float startAngle, float endAngle,
                                       int angularResolution, int verticalResolution) {
+    GeneratorProfileSpan profile(__func__);
     const int vertical = verticalResolution > 0 ? verticalResolution : 1;
     const int angular = angularResolution > 1 ? angularResolution : 2;
 
@@ -1805,8 +2033,8 @@ GeometryData generateTubeGeometryData(float radius, float height, float startAng
     const int vertices = perLoop * (vertical + 1);
     const int triangles = angular * 2 * vertical;
 
-    Vertex *vtx = (Vertex *)malloc(vertices * sizeof(Vertex));
-    TriangleIndices *ind = (TriangleIndices *)malloc(triangles * sizeof(TriangleIndices));
+    Vertex *vtx = allocateVertexData(vertices);
+    TriangleIndices *ind = allocateIndexData(triangles);
 
     int vertexIndex = 0;
     int triangleIndex = 0;
@@ -1840,9 +2068,9 @@ GeometryData generateTubeGeometryData(float radius, float height, float startAng
         }
     }
 
-    return (GeometryData) {
+    return profile.finish((GeometryData) {
         .vertexCount = vertices, .vertexData = vtx, .indexCount = triangles, .indexData = ind
-    };
+    });
 }
 
 enum PatchEdge {
@@ -1989,7 +2217,7 @@ void connectPatchCorners(GeometryData *dst, int n, int firstPatchIndex, int seco
     const int i2 = thirdPatchIndex * verticesPerPatch + getPatchCornerOffset(n, thirdPatchCorner);
     const int i3 = fourthPatchIndex * verticesPerPatch + getPatchCornerOffset(n, fourthPatchCorner);
 
-    TriangleIndices *tris = (TriangleIndices *)malloc(triangles * sizeof(TriangleIndices));
+    TriangleIndices *tris = allocateIndexData(triangles);
     tris[0] = (TriangleIndices) { .i0 = i0, .i1 = i1, .i2 = i2 };
     tris[1] = (TriangleIndices) { .i0 = i0, .i1 = i2, .i2 = i3 };
     addTrianglesToGeometryData(dst, tris, triangles);
@@ -1998,8 +2226,10 @@ void connectPatchCorners(GeometryData *dst, int n, int firstPatchIndex, int seco
 
 GeometryData generateRoundedBoxGeometryData(float width, float height, float depth, float radius,
                                             int res) {
+    GeneratorProfileSpan profile(__func__);
     if (radius == 0) {
-        return generateBoxGeometryData(width, height, depth, 0.0, 0.0, 0.0, 1, 1, 1);
+        return profile.finish(
+            generateBoxGeometryData(width, height, depth, 0.0, 0.0, 0.0, 1, 1, 1));
     }
 
     const int n = (1 << res) + 1;
@@ -2033,8 +2263,8 @@ GeometryData generateRoundedBoxGeometryData(float width, float height, float dep
     const int vertices = verticesPerPatch * patches;
     const int triangles = trianglesPerPatch * patches;
 
-    Vertex *vtx = (Vertex *)malloc(vertices * sizeof(Vertex));
-    TriangleIndices *ind = (TriangleIndices *)malloc(triangles * sizeof(TriangleIndices));
+    Vertex *vtx = allocateVertexData(vertices);
+    TriangleIndices *ind = allocateIndexData(triangles);
 
     const int nMinusOne = n - 1;
     const float nMinusOnef = nf - 1.0;
@@ -2111,7 +2341,7 @@ GeometryData generateRoundedBoxGeometryData(float width, float height, float dep
     {
         // Patch: 0 - Front Top Right Corner
         {
-            GeometryData copy;
+            GeometryData copy = createGeometryData();
             copyGeometryData(&copy, &corner);
             transformGeometryData(&copy, translationMatrixf(wph, hph, dph));
             combineGeometryData(&geoData, &copy);
@@ -2120,7 +2350,7 @@ GeometryData generateRoundedBoxGeometryData(float width, float height, float dep
 
         // Patch: 1 - Front Top Left Corner
         {
-            GeometryData copy;
+            GeometryData copy = createGeometryData();
             copyGeometryData(&copy, &corner);
             simd_float4x4 transform = translationMatrixf(-wph, hph, dph);
             const simd_quatf quat = simd_quaternion(-M_PI_2, simd_make_float3(0.0, 1.0, 0.0));
@@ -2132,7 +2362,7 @@ GeometryData generateRoundedBoxGeometryData(float width, float height, float dep
 
         // Patch: 2 - Front Bottom Left Corner
         {
-            GeometryData copy;
+            GeometryData copy = createGeometryData();
             copyGeometryData(&copy, &corner);
             simd_float4x4 transform = translationMatrixf(-wph, -hph, dph);
             simd_quatf quat = simd_quaternion(M_PI, simd_make_float3(0.0, 0.0, 1.0));
@@ -2144,7 +2374,7 @@ GeometryData generateRoundedBoxGeometryData(float width, float height, float dep
 
         // Patch: 3 - Front Bottom Right Corner
         {
-            GeometryData copy;
+            GeometryData copy = createGeometryData();
             copyGeometryData(&copy, &corner);
             simd_float4x4 transform = translationMatrixf(wph, -hph, dph);
             simd_quatf quat = simd_quaternion(-M_PI_2, simd_make_float3(0.0, 0.0, 1.0));
@@ -2156,7 +2386,7 @@ GeometryData generateRoundedBoxGeometryData(float width, float height, float dep
 
         // Patch: 4 - Back Top Right Corner
         {
-            GeometryData copy;
+            GeometryData copy = createGeometryData();
             copyGeometryData(&copy, &corner);
             simd_float4x4 transform = translationMatrixf(wph, hph, -dph);
             simd_quatf quat = simd_quaternion(M_PI_2, simd_make_float3(0.0, 1.0, 0.0));
@@ -2168,7 +2398,7 @@ GeometryData generateRoundedBoxGeometryData(float width, float height, float dep
 
         // Patch: 5 - Back Top Left Corner
         {
-            GeometryData copy;
+            GeometryData copy = createGeometryData();
             copyGeometryData(&copy, &corner);
             simd_float4x4 transform = translationMatrixf(-wph, hph, -dph);
             simd_quatf quat = simd_quaternion(M_PI, simd_make_float3(0.0, 1.0, 0.0));
@@ -2180,7 +2410,7 @@ GeometryData generateRoundedBoxGeometryData(float width, float height, float dep
 
         // Patch: 6 - Back Bottom Left Corner
         {
-            GeometryData copy;
+            GeometryData copy = createGeometryData();
             copyGeometryData(&copy, &corner);
             simd_float4x4 transform = translationMatrixf(-wph, -hph, -dph);
             simd_quatf quat = simd_quaternion(M_PI, simd_make_float3(0.0, 1.0, 0.0));
@@ -2193,7 +2423,7 @@ GeometryData generateRoundedBoxGeometryData(float width, float height, float dep
 
         // Patch: 7 - Back Bottom Right Corner
         {
-            GeometryData copy;
+            GeometryData copy = createGeometryData();
             copyGeometryData(&copy, &corner);
             simd_float4x4 transform = translationMatrixf(wph, -hph, -dph);
             simd_quatf quat = simd_quaternion(M_PI_2, simd_make_float3(0.0, 1.0, 0.0));
@@ -2252,5 +2482,5 @@ GeometryData generateRoundedBoxGeometryData(float width, float height, float dep
                         PatchCornerRight);
 
     computeNormalsOfGeometryData(&geoData);
-    return geoData;
+    return profile.finish(geoData);
 }
@@ -6,6 +6,7 @@
 //
 
 #include <float.h>
+#include <string.h>
 #include "Geometry.h"
 
 bool greaterThanZero(float a) { return a > FLT_EPSILON; }
@@ -340,3 +341,411 @@ simd_float3 getBarycentricCoordinates(simd_float3 p, simd_float3 a, simd_float3
     const float u = 1.0 - v - w;
     return simd_make_float3(u, v, w);
 }
+
+/* Packet Intersections */
+
+// FMA contraction is disabled in the packet kernels so the vector & scalar paths round the same way
+
+static simd_int4 packetLaneBits(simd_int4) { return simd_make_int4(1, 2, 4, 8); }
+
+static simd_int8 packetLaneBits(simd_int8) { return (simd_int8) { 1, 2, 4, 8, 16, 32, 64, 128 }; }
+
+template <typename I> static int packetMask(I valid)
+{
+    if (!simd_any(valid)) { return 0; }
+    return simd_reduce_add(valid & packetLaneBits(valid));
+}
+
+static int nearestPacketLane(const float *times, int mask, int lanes, float *time, int *lane)
+{
+    int nearest = -1;
+    for (int i = 0; i < lanes; i++) {
+        if ((mask & (1 << i)) && (nearest < 0 || times[i] < times[nearest])) { nearest = i; }
+    }
+    if (nearest >= 0) {
+        if (time != NULL) { *time = times[nearest]; }
+        if (lane != NULL) { *lane = nearest; }
+    }
+    return mask;
+}
+
+// ties go to the lowest lane like the scalar search
+template <typename F, typename I>
+static int nearestPacketLane(F times, I valid, float *time, int *lane)
+{
+    const int mask = packetMask(valid);
+    if (mask == 0) { return 0; }
+
+    const F none = INFINITY;
+    const F candidates = simd_select(none, times, valid);
+    const float nearest = simd_reduce_min(candidates);
+    if (time != NULL) { *time = nearest; }
+    if (lane != NULL) { *lane = __builtin_ctz(packetMask(valid & (candidates == nearest))); }
+    return mask;
+}
+
+template <typename F, typename I> static F packetMin(F a, F b) { return simd_select(b, a, a < b); }
+
+template <typename F, typename I> static F packetMax(F a, F b) { return simd_select(b, a, a > b); }
+
+static float scalarMin(float a, float b) { return a < b ? a : b; }
+
+static float scalarMax(float a, float b) { return a > b ? a : b; }
+
+template <typename P> static void setTrianglePacket(P *packet, int lane, simd_float3 p0,
+                                                    simd_float3 p1, simd_float3 p2)
+{
+    const simd_float3 e1 = p1 - p0;
+    const simd_float3 e2 = p2 - p0;
+    packet->v0x[lane] = p0.x;
+    packet->v0y[lane] = p0.y;
+    packet->v0z[lane] = p0.z;
+    packet->e1x[lane] = e1.x;
+    packet->e1y[lane] = e1.y;
+    packet->e1z[lane] = e1.z;
+    packet->e2x[lane] = e2.x;
+    packet->e2y[lane] = e2.y;
+    packet->e2z[lane] = e2.z;
+}
+
+template <typename P> static void setBoundsPacket(P *packet, int lane, Bounds bounds)
+{
+    packet->minX[lane] = bounds.min.x;
+    packet->minY[lane] = bounds.min.y;
+    packet->minZ[lane] = bounds.min.z;
+    packet->maxX[lane] = bounds.max.x;
+    packet->maxY[lane] = bounds.max.y;
+    packet->maxZ[lane] = bounds.max.z;
+}
+
+template <typename P, int N> static P createBoundsPacket(void)
+{
+    P packet;
+    for (int i = 0; i < N; i++) {
+        setBoundsPacket(&packet, i,
+                        (Bounds) { .min = { INFINITY, INFINITY, INFINITY },
+                                   .max = { -INFINITY, -INFINITY, -INFINITY } });
+    }
+    return packet;
+}
+
+TrianglePacket4 createTrianglePacket4(void)
+{
+    TrianglePacket4 packet;
+    memset(&packet, 0, sizeof(TrianglePacket4));
+    return packet;
+}
+
+TrianglePacket8 createTrianglePacket8(void)
+{
+    TrianglePacket8 packet;
+    memset(&packet, 0, sizeof(TrianglePacket8));
+    return packet;
+}
+
+BoundsPacket4 createBoundsPacket4(void) { return createBoundsPacket<BoundsPacket4, 4>(); }
+
+BoundsPacket8 createBoundsPacket8(void) { return createBoundsPacket<BoundsPacket8, 8>(); }
+
+EdgePacket4 createEdgePacket4(void)
+{
+    EdgePacket4 packet;
+    memset(&packet, 0, sizeof(EdgePacket4));
+    return packet;
+}
+
+void setTrianglePacket4(TrianglePacket4 *packet, int lane, simd_float3 p0, simd_float3 p1,
+                        simd_float3 p2)
+{
+    setTrianglePacket(packet, lane, p0, p1, p2);
+}
+
+void setTrianglePacket8(TrianglePacket8 *packet, int lane, simd_float3 p0, simd_float3 p1,
+                        simd_float3 p2)
+{
+    setTrianglePacket(packet, lane, p0, p1, p2);
+}
+
+void setBoundsPacket4(BoundsPacket4 *packet, int lane, Bounds bounds)
+{
+    setBoundsPacket(packet, lane, bounds);
+}
+
+void setBoundsPacket8(BoundsPacket8 *packet, int lane, Bounds bounds)
+{
+    setBoundsPacket(packet, lane, bounds);
+}
+
+void setEdgePacket4(EdgePacket4 *packet, int lane, simd_float2 a, simd_float2 b)
+{
+    packet->x0[lane] = a.x;
+    packet->y0[lane] = a.y;
+    packet->x1[lane] = b.x;
+    packet->y1[lane] = b.y;
+}
+
+// Möller–Trumbore, same as rayTriangleIntersectionTime
+template <typename F, typename I, typename P>
+static int rayTrianglePacketIntersect(Ray ray, const P *p, float *time, int *lane)
+{
+#pragma clang fp contract(off)
+    const float ox = ray.origin.x, oy = ray.origin.y, oz = ray.origin.z;
+    const float dx = ray.direction.x, dy = ray.direction.y, dz = ray.direction.z;
+
+    const F hx = dy * p->e2z - dz * p->e2y;
+    const F hy = dz * p->e2x - dx * p->e2z;
+    const F hz = dx * p->e2y - dy * p->e2x;
+    const F a = p->e1x * hx + p->e1y * hy + p->e1z * hz;
+    I valid = ~((a > -FLT_EPSILON) & (a < FLT_EPSILON));
+
+    const F f = 1.0f / a;
+    const F sx = ox - p->v0x;
+    const F sy = oy - p->v0y;
+    const F sz = oz - p->v0z;
+    const F u = f * (sx * hx + sy * hy + sz * hz);
+    valid &= ~((u < 0.0f) | (u > 1.0f));
+
+    const F qx = sy * p->e1z - sz * p->e1y;
+    const F qy = sz * p->e1x - sx * p->e1z;
+    const F qz = sx * p->e1y - sy * p->e1x;
+    const F v = f * (dx * qx + dy * qy + dz * qz);
+    valid &= ~((v < 0.0f) | (u + v > 1.0f));
+
+    const F t = f * (p->e2x * qx + p->e2y * qy + p->e2z * qz);
+    valid &= t > FLT_EPSILON;
+
+    return nearestPacketLane(t, valid, time, lane);
+}
+
+template <int N, typename P>
+static int rayTrianglePacketIntersectScalar(Ray ray, const P *p, float *time, int *lane)
+{
+#pragma clang fp contract(off)
+    const float ox = ray.origin.x, oy = ray.origin.y, oz = ray.origin.z;
+    const float dx = ray.direction.x, dy = ray.direction.y, dz = ray.direction.z;
+
+    float times[N];
+    int mask = 0;
+    for (int i = 0; i < N; i++) {
+        times[i] = 0.0f;
+        const float e1x = p->e1x[i], e1y = p->e1y[i], e1z = p->e1z[i];
+        const float e2x = p->e2x[i], e2y = p->e2y[i], e2z = p->e2z[i];
+
+        const float hx = dy * e2z - dz * e2y;
+        const float hy = dz * e2x - dx * e2z;
+        const float hz = dx * e2y - dy * e2x;
+        const float a = e1x * hx + e1y * hy + e1z * hz;
+        if (a > -FLT_EPSILON && a < FLT_EPSILON) continue;
+
+        const float f = 1.0f / a;
+        const float sx = ox - p->v0x[i];
+        const float sy = oy - p->v0y[i];
+        const float sz = oz - p->v0z[i];
+        const float u = f * (sx * hx + sy * hy + sz * hz);
+        if (u < 0.0f || u > 1.0f) continue;
+
+        const float qx = sy * e1z - sz * e1y;
+        const float qy = sz * e1x - sx * e1z;
+        const float qz = sx * e1y - sy * e1x;
+        const float v = f * (dx * qx + dy * qy + dz * qz);
+        if (v < 0.0f || u + v > 1.0f) continue;
+
+        const float t = f * (e2x * qx + e2y * qy + e2z * qz);
+        times[i] = t;
+        if (t > FLT_EPSILON) { mask |= 1 << i; }
+    }
+
+    return nearestPacketLane(times, mask, N, time, lane);
+}
+
+// Slab test, same as rayBoundsIntersection with empty bounds & bounds behind the ray rejected
+template <typename F, typename I, typename P>
+static int rayBoundsPacketIntersect(Ray ray, const P *p, float *time, int *lane)
+{
+#pragma clang fp contract(off)
+    const simd_float3 dirInv = 1.0f / ray.direction;
+
+    const F t0x = (p->minX - ray.origin.x) * dirInv.x;
+    const F t1x = (p->maxX - ray.origin.x) * dirInv.x;
+    const F t0y = (p->minY - ray.origin.y) * dirInv.y;
+    const F t1y = (p->maxY - ray.origin.y) * dirInv.y;
+    const F t0z = (p->minZ - ray.origin.z) * dirInv.z;
+    const F t1z = (p->maxZ - ray.origin.z) * dirInv.z;
+
+    const F tNear = packetMax<F, I>(
+        packetMax<F, I>(packetMin<F, I>(t0x, t1x), packetMin<F, I>(t0y, t1y)),
+        packetMin<F, I>(t0z, t1z));
+    const F tFar = packetMin<F, I>(
+        packetMin<F, I>(packetMax<F, I>(t0x, t1x), packetMax<F, I>(t0y, t1y)),
+        packetMax<F, I>(t0z, t1z));
+
+    const I valid = (p->minX <= p->maxX) & (p->minY <= p->maxY) & (p->minZ <= p->maxZ) &
+                    (tNear <= tFar) & (tFar >= 0.0f);
+
+    return nearestPacketLane(tNear, valid, time, lane);
+}
+
+template <int N, typename P>
+static int rayBoundsPacketIntersectScalar(Ray ray, const P *p, float *time, int *lane)
+{
+#pragma clang fp contract(off)
+    const simd_float3 dirInv = 1.0f / ray.direction;
+
+    float times[N];
+    int mask = 0;
+    for (int i = 0; i < N; i++) {
+        const float t0x = (p->minX[i] - ray.origin.x) * dirInv.x;
+        const float t1x = (p->maxX[i] - ray.origin.x) * dirInv.x;
+        const float t0y = (p->minY[i] - ray.origin.y) * dirInv.y;
+        const float t1y = (p->maxY[i] - ray.origin.y) * dirInv.y;
+        const float t0z = (p->minZ[i] - ray.origin.z) * dirInv.z;
+        const float t1z = (p->maxZ[i] - ray.origin.z) * dirInv.z;
+
+        const float tNear = scalarMax(scalarMax(scalarMin(t0x, t1x), scalarMin(t0y, t1y)),
+                                      scalarMin(t0z, t1z));
+        const float tFar = scalarMin(scalarMin(scalarMax(t0x, t1x), scalarMax(t0y, t1y)),
+                                     scalarMax(t0z, t1z));
+        times[i] = tNear;
+
+        if (p->minX[i] <= p->maxX[i] && p->minY[i] <= p->maxY[i] && p->minZ[i] <= p->maxZ[i] &&
+            tNear <= tFar && tFar >= 0.0f) {
+            mask |= 1 << i;
+        }
+    }
+
+    return nearestPacketLane(times, mask, N, time, lane);
+}
+
+int rayTrianglePacket4Intersect(Ray ray, const TrianglePacket4 *packet, float *time, int *lane)
+{
+    return rayTrianglePacketIntersect<simd_float4, simd_int4>(ray, packet, time, lane);
+}
+
+int rayTrianglePacket4IntersectScalar(Ray ray, const TrianglePacket4 *packet, float *time,
+                                      int *lane)
+{
+    return rayTrianglePacketIntersectScalar<4>(ray, packet, time, lane);
+}
+
+int rayTrianglePacket8Intersect(Ray ray, const TrianglePacket8 *packet, float *time, int *lane)
+{
+    return rayTrianglePacketIntersect<simd_float8, simd_int8>(ray, packet, time, lane);
+}
+
+int rayTrianglePacket8IntersectScalar(Ray ray, const TrianglePacket8 *packet, float *time,
+                                      int *lane)
+{
+    return rayTrianglePacketIntersectScalar<8>(ray, packet, time, lane);
+}
+
+int rayBoundsPacket4Intersect(Ray ray, const BoundsPacket4 *packet, float *time, int *lane)
+{
+    return rayBoundsPacketIntersect<simd_float4, simd_int4>(ray, packet, time, lane);
+}
+
+int rayBoundsPacket4IntersectScalar(Ray ray, const BoundsPacket4 *packet, float *time, int *lane)
+{
+    return rayBoundsPacketIntersectScalar<4>(ray, packet, time, lane);
+}
+
+int rayBoundsPacket8Intersect(Ray ray, const BoundsPacket8 *packet, float *time, int *lane)
+{
+    return rayBoundsPacketIntersect<simd_float8, simd_int8>(ray, packet, time, lane);
+}
+
+int rayBoundsPacket8IntersectScalar(Ray ray, const BoundsPacket8 *packet, float *time, int *lane)
+{
+    return rayBoundsPacketIntersectScalar<8>(ray, packet, time, lane);
+}
+
+static simd_int4 isZeroPacket4(simd_float4 a)
+{
+    return (a == 0.0f) | (simd_abs(a) < FLT_EPSILON);
+}
+
+static bool isZeroScalar(float a) { return a == 0.0f || fabsf(a) < FLT_EPSILON; }
+
+int isLeftPacket4(simd_float2 a, simd_float2 b, simd_float4 cx, simd_float4 cy)
+{
+#pragma clang fp contract(off)
+    const simd_float4 area = (b.x - a.x) * (cy - a.y) - (cx - a.x) * (b.y - a.y);
+    return packetMask(area > FLT_EPSILON);
+}
+
+int isLeftPacket4Scalar(simd_float2 a, simd_float2 b, simd_float4 cx, simd_float4 cy)
+{
+#pragma clang fp contract(off)
+    int mask = 0;
+    for (int i = 0; i < 4; i++) {
+        const float area = (b.x - a.x) * (cy[i] - a.y) - (cx[i] - a.x) * (b.y - a.y);
+        if (area > FLT_EPSILON) { mask |= 1 << i; }
+    }
+    return mask;
+}
+
+int isBetweenPacket4(simd_float2 a, simd_float2 b, simd_float4 cx, simd_float4 cy)
+{
+#pragma clang fp contract(off)
+    const simd_float4 area = (b.x - a.x) * (cy - a.y) - (cx - a.x) * (b.y - a.y);
+    const int axis = (a.x != b.x) ? 0 : 1;
+    const simd_float4 c = axis == 0 ? cx : cy;
+    const simd_int4 between =
+        ((a[axis] <= c) & (c <= b[axis])) | ((a[axis] >= c) & (c >= b[axis]));
+    return packetMask(isZeroPacket4(area) & between);
+}
+
+int isBetweenPacket4Scalar(simd_float2 a, simd_float2 b, simd_float4 cx, simd_float4 cy)
+{
+#pragma clang fp contract(off)
+    const int axis = (a.x != b.x) ? 0 : 1;
+    int mask = 0;
+    for (int i = 0; i < 4; i++) {
+        const float area = (b.x - a.x) * (cy[i] - a.y) - (cx[i] - a.x) * (b.y - a.y);
+        if (!isZeroScalar(area)) continue;
+        const float c = axis == 0 ? cx[i] : cy[i];
+        if ((a[axis] <= c && c <= b[axis]) || (a[axis] >= c && c >= b[axis])) { mask |= 1 << i; }
+    }
+    return mask;
+}
+
+int intersectsProperPacket4(simd_float2 a, simd_float2 b, const EdgePacket4 *edges)
+{
+#pragma clang fp contract(off)
+    const simd_float4 cx = edges->x0, cy = edges->y0;
+    const simd_float4 dx = edges->x1, dy = edges->y1;
+
+    const simd_float4 abc = (b.x - a.x) * (cy - a.y) - (cx - a.x) * (b.y - a.y);
+    const simd_float4 abd = (b.x - a.x) * (dy - a.y) - (dx - a.x) * (b.y - a.y);
+    const simd_float4 cda = (dx - cx) * (a.y - cy) - (a.x - cx) * (dy - cy);
+    const simd_float4 cdb = (dx - cx) * (b.y - cy) - (b.x - cx) * (dy - cy);
+
+    const simd_int4 colinear =
+        isZeroPacket4(abc) | isZeroPacket4(abd) | isZeroPacket4(cda) | isZeroPacket4(cdb);
+    const simd_int4 crosses = ((abc > FLT_EPSILON) ^ (abd > FLT_EPSILON)) &
+                              ((cda > FLT_EPSILON) ^ (cdb > FLT_EPSILON));
+    return packetMask(~colinear & crosses);
+}
+
+int intersectsProperPacket4Scalar(simd_float2 a, simd_float2 b, const EdgePacket4 *edges)
+{
+#pragma clang fp contract(off)
+    int mask = 0;
+    for (int i = 0; i < 4; i++) {
+        const float cx = edges->x0[i], cy = edges->y0[i];
+        const float dx = edges->x1[i], dy = edges->y1[i];
+
+        const float abc = (b.x - a.x) * (cy - a.y) - (cx - a.x) * (b.y - a.y);
+        const float abd = (b.x - a.x) * (dy - a.y) - (dx - a.x) * (b.y - a.y);
+        const float cda = (dx - cx) * (a.y - cy) - (a.x - cx) * (dy - cy);
+        const float cdb = (dx - cx) * (b.y - cy) - (b.x - cx) * (dy - cy);
+
+        if (isZeroScalar(abc) || isZeroScalar(abd) || isZeroScalar(cda) || isZeroScalar(cdb)) {
+            continue;
+        }
+        if (((abc > FLT_EPSILON) ^ (abd > FLT_EPSILON)) &&
+            ((cda > FLT_EPSILON) ^ (cdb > FLT_EPSILON))) {
+            mask |= 1 << i;
+        }
+    }
+    return mask;
+}
@@ -0,0 +1,161 @@
+//
+//  GeometryJobs.mm
+//  Satin
+//
+//  Created by agent on 10/19/26.
+//
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "Bvh.h"
+#include "Generators.h"
+#include "GeometryJobs.h"
+
+// The jobs behind a composite handle, every member counts itself out once its work has run or it
+// was cancelled so cancelling the handle can wait for the members that already started
+struct GeometryJobGroup {
+    std::mutex mutex;
+    std::condition_variable condition;
+    int remaining = 0;
+    std::vector<Job *> jobs;
+
+    ~GeometryJobGroup()
+    {
+        for (Job *job : jobs) {
+            releaseJob(job);
+        }
+    }
+
+    void finishMember()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            remaining--;
+        }
+        condition.notify_all();
+    }
+
+    void cancel()
+    {
+        for (auto it = jobs.rbegin(); it != jobs.rend(); it++) {
+            cancelJob(*it);
+        }
+        std::unique_lock<std::mutex> lock(mutex);
+        condition.wait(lock, [this] { return remaining == 0; });
+    }
+};
+
+static Job *submitGroupMember(JobSystem *system, const std::shared_ptr<GeometryJobGroup> &group,
+                              std::function<void()> work, Job **dependencies, int dependencyCount)
+{
+    {
+        std::lock_guard<std::mutex> lock(group->mutex);
+        group->remaining++;
+    }
+    Job *job = submitJobClosure(
+        system,
+        [group, work] {
+            work();
+            group->finishMember();
+        },
+        [group] { group->finishMember(); }, dependencies, dependencyCount);
+    group->jobs.push_back(job);
+    return job;
+}
+
+// Finishes after every member, cancelling it cancels the members that haven't started and
+// returns once the running ones are done
+static Job *submitGroupHandle(JobSystem *system, const std::shared_ptr<GeometryJobGroup> &group)
+{
+    return submitJobClosure(
+        system, [] {}, [group] { group->cancel(); }, group->jobs.data(), (int)group->jobs.size());
+}
+
+Job *submitGenerateGeometryJob(JobSystem *system, GeometryGenerator generator,
+                               const void *parameters, GeometryData *output, Job **dependencies,
+                               int dependencyCount)
+{
+    return submitJobClosure(
+        system, [generator, parameters, output] { *output = generator(parameters); }, nullptr,
+        dependencies, dependencyCount);
+}
+
+Job *submitCombineGeometryJob(JobSystem *system, GeometryData *dest, GeometryData *sources,
+                              int sourceCount, Job **dependencies, int dependencyCount)
+{
+    return submitJobClosure(
+        system,
+        [dest, sources, sourceCount] {
+            for (int i = 0; i < sourceCount; i++) {
+                combineGeometryData(dest, &sources[i]);
+            }
+        },
+        nullptr, dependencies, dependencyCount);
+}
+
+Job *submitComputeNormalsJob(JobSystem *system, GeometryData *data, Job **dependencies,
+                             int dependencyCount)
+{
+    return submitJobClosure(
+        system, [data] { computeNormalsOfGeometryData(data); }, nullptr, dependencies,
+        dependencyCount);
+}
+
+Job *submitCreateBVHJob(JobSystem *system, GeometryData *data, bool useSAH, BVH *output,
+                        Job **dependencies, int dependencyCount)
+{
+    return submitJobClosure(
+        system, [data, useSAH, output] { *output = createBVH(*data, useSAH); }, nullptr,
+        dependencies, dependencyCount);
+}
+
+Job *submitGeometryPipeline(JobSystem *system, GeometryGenerator generator, const void *parameters,
+                            bool computeNormals, GeometryData *output, BVH *bvh, bool useSAH)
+{
+    if (!computeNormals && bvh == NULL) {
+        return submitGenerateGeometryJob(system, generator, parameters, output, NULL, 0);
+    }
+
+    auto group = std::make_shared<GeometryJobGroup>();
+    Job *last = submitGroupMember(
+        system, group, [generator, parameters, output] { *output = generator(parameters); }, NULL,
+        0);
+    if (computeNormals) {
+        last = submitGroupMember(
+            system, group, [output] { computeNormalsOfGeometryData(output); }, &last, 1);
+    }
+    if (bvh != NULL) {
+        last = submitGroupMember(
+            system, group, [output, useSAH, bvh] { *bvh = createBVH(*output, useSAH); }, &last,
+            1);
+    }
+    return submitGroupHandle(system, group);
+}
+
+Job *submitGridTileJobs(JobSystem *system, const GridTileParameters *parameters,
+                        GeometryTileCallback callback, void *context)
+{
+    const GridTileParameters params = *parameters;
+    int columns = 0;
+    int rows = 0;
+    getGridTileCounts(&params, &columns, &rows);
+
+    auto group = std::make_shared<GeometryJobGroup>();
+    group->jobs.reserve((size_t)columns * rows);
+    for (int y = 0; y < rows; y++) {
+        for (int x = 0; x < columns; x++) {
+            submitGroupMember(
+                system, group,
+                [params, x, y, callback, context] {
+                    GeometryTile tile = generateGridTile(&params, x, y);
+                    callback(&tile, context);
+                    freeGeometryTile(&tile);
+                },
+                NULL, 0);
+        }
+    }
+    return submitGroupHandle(system, group);
+}
@@ -0,0 +1,361 @@
+//
+//  GeometryStore.mm
+//  Satin
+//
+//  Created by agent on 10/19/26.
+//
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <string.h>
+#include <unordered_map>
+
+#include "Bounds.h"
+#include "Bvh.h"
+#include "GeometryStore.h"
+
+// Twelve 32 bit lanes of xxHash32 style rounds, a vertex is three 16 byte blocks so a whole vertex
+// goes through the lanes at once, indices go through them four triangles at a time
+
+static_assert(sizeof(Vertex) == 48, "vertices are hashed as three 16 byte blocks");
+
+#define HASH_PRIME32_1 0x9E3779B1u
+#define HASH_PRIME32_2 0x85EBCA77u
+#define HASH_PRIME64_1 0x9E3779B97F4A7C15ull
+#define HASH_PRIME64_2 0xC2B2AE3D27D4EB4Full
+
+typedef struct {
+    simd_uint4 lanes[3];
+} GeometryHashState;
+
+static inline simd_uint4 hashRound(simd_uint4 lane, simd_uint4 input)
+{
+    lane += input * HASH_PRIME32_2;
+    lane = (lane << 13) | (lane >> 19);
+    return lane * HASH_PRIME32_1;
+}
+
+static inline void hashBlocks(GeometryHashState *state, const simd_uint4 blocks[3])
+{
+    state->lanes[0] = hashRound(state->lanes[0], blocks[0]);
+    state->lanes[1] = hashRound(state->lanes[1], blocks[1]);
+    state->lanes[2] = hashRound(state->lanes[2], blocks[2]);
+}
+
+// The normal's fourth float and the eight bytes after uv are padding, they're masked out so
+// meshes with the same values match whatever their padding holds
+static inline void loadVertexBlocks(const Vertex *vertex, simd_uint4 blocks[3])
+{
+    const simd_uint4 normalMask = { 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0 };
+    const simd_uint4 uvMask = { 0xFFFFFFFF, 0xFFFFFFFF, 0, 0 };
+    memcpy(blocks, vertex, sizeof(Vertex));
+    blocks[1] &= normalMask;
+    blocks[2] &= uvMask;
+}
+
+uint64_t hashGeometryData(const GeometryData *data)
+{
+    const simd_uint4 seed = { HASH_PRIME32_1 + HASH_PRIME32_2, HASH_PRIME32_2, 0,
+                              0u - HASH_PRIME32_1 };
+    GeometryHashState state = { .lanes = { seed, seed + 1u, seed + 2u } };
+
+    simd_uint4 blocks[3];
+    for (int i = 0; i < data->vertexCount; i++) {
+        loadVertexBlocks(&data->vertexData[i], blocks);
+        hashBlocks(&state, blocks);
+    }
+
+    const uint8_t *indices = (const uint8_t *)data->indexData;
+    const size_t length = (size_t)std::max(data->indexCount, 0) * sizeof(TriangleIndices);
+    size_t offset = 0;
+    for (; offset + sizeof(blocks) <= length; offset += sizeof(blocks)) {
+        memcpy(blocks, indices + offset, sizeof(blocks));
+        hashBlocks(&state, blocks);
+    }
+    if (offset < length) {
+        memset(blocks, 0, sizeof(blocks));
+        memcpy(blocks, indices + offset, length - offset);
+        hashBlocks(&state, blocks);
+    }
+
+    // the counts keep the zero padded tail from matching a longer mesh
+    uint64_t hash = (uint64_t)data->vertexCount * HASH_PRIME64_1;
+    hash ^= (uint64_t)data->indexCount * HASH_PRIME64_2;
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 4; j++) {
+            hash ^= state.lanes[i][j];
+            hash = ((hash << 27) | (hash >> 37)) * HASH_PRIME64_1 + HASH_PRIME64_2;
+        }
+    }
+
+    hash ^= hash >> 33;
+    hash *= 0xFF51AFD7ED558CCDull;
+    hash ^= hash >> 33;
+    hash *= 0xC4CEB9FE1A85EC53ull;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+static bool equalGeometryData(const GeometryData *a, const GeometryData *b)
+{
+    if (a->vertexCount != b->vertexCount || a->indexCount != b->indexCount) { return false; }
+
+    simd_uint4 blocksA[3];
+    simd_uint4 blocksB[3];
+    for (int i = 0; i < a->vertexCount; i++) {
+        loadVertexBlocks(&a->vertexData[i], blocksA);
+        loadVertexBlocks(&b->vertexData[i], blocksB);
+        if (simd_any((blocksA[0] != blocksB[0]) | (blocksA[1] != blocksB[1]) |
+                     (blocksA[2] != blocksB[2]))) {
+            return false;
+        }
+    }
+
+    return a->indexCount <= 0 ||
+           memcmp(a->indexData, b->indexData, a->indexCount * sizeof(TriangleIndices)) == 0;
+}
+
+struct GeometryStoreEntry {
+    GeometryStore *store;
+    GeometryData geometry;
+    uint64_t hash;
+    int references; // guarded by the store's mutex
+
+    std::once_flag boundsOnce;
+    Bounds bounds;
+
+    std::once_flag bvhOnce;
+    BVH bvh;
+    std::atomic<bool> hasBVH;
+};
+
+struct GeometryStore {
+    mutable std::mutex mutex;
+    // equal hashes with different contents get entries of their own
+    std::unordered_multimap<uint64_t, GeometryStoreEntry *> entries;
+    bool useSAH;
+    int referenceCount;
+    int64_t internCount;
+    int64_t hitCount;
+    std::atomic<int> bvhCount;
+    std::atomic<int64_t> bvhRequestCount;
+};
+
+static size_t getGeometryDataBytes(const GeometryData *data)
+{
+    return (size_t)data->vertexCount * sizeof(Vertex) +
+           (size_t)data->indexCount * sizeof(TriangleIndices);
+}
+
+// Matches the allocations createBVH makes
+static size_t getGeometryStoreEntryBVHBytes(const GeometryStoreEntry *entry)
+{
+    const GeometryData *data = &entry->geometry;
+    const size_t triangles = data->indexCount > 0 ? data->indexCount : data->vertexCount / 3;
+    size_t bytes = triangles * (2 * sizeof(BVHNode) + sizeof(simd_float3) + sizeof(uint32_t));
+    if (entry->bvh.ownsTriangles) { bytes += triangles * sizeof(TriangleIndices); }
+    return bytes;
+}
+
+static void freeGeometryStoreEntry(GeometryStoreEntry *entry)
+{
+    // the BVH reads the entry's geometry in place
+    if (entry->hasBVH.load(std::memory_order_acquire)) { freeBVH(entry->bvh); }
+    freeGeometryData(&entry->geometry);
+    delete entry;
+}
+
+GeometryStore *createGeometryStore(bool useSAH)
+{
+    GeometryStore *store = new GeometryStore();
+    store->useSAH = useSAH;
+    store->referenceCount = 0;
+    store->internCount = 0;
+    store->hitCount = 0;
+    store->bvhCount = 0;
+    store->bvhRequestCount = 0;
+    return store;
+}
+
+void freeGeometryStore(GeometryStore *store)
+{
+    for (auto &item : store->entries) {
+        freeGeometryStoreEntry(item.second);
+    }
+    delete store;
+}
+
+// Both expect the store's mutex to be held
+
+static GeometryStoreEntry *findGeometryStoreEntry(GeometryStore *store, uint64_t hash,
+                                                  const GeometryData *data)
+{
+    auto range = store->entries.equal_range(hash);
+    for (auto it = range.first; it != range.second; it++) {
+        if (equalGeometryData(&it->second->geometry, data)) { return it->second; }
+    }
+    return NULL;
+}
+
+static GeometryStoreEntry *addGeometryStoreEntry(GeometryStore *store, uint64_t hash,
+                                                 GeometryData geometry)
+{
+    GeometryStoreEntry *entry = new GeometryStoreEntry();
+    entry->store = store;
+    entry->geometry = geometry;
+    entry->hash = hash;
+    entry->references = 1;
+    entry->bounds = createBounds();
+    entry->bvh = (BVH) {};
+    entry->hasBVH = false;
+
+    store->entries.emplace(hash, entry);
+    store->referenceCount++;
+    return entry;
+}
+
+GeometryStoreEntry *internGeometryData(GeometryStore *store, GeometryData *data)
+{
+    const uint64_t hash = hashGeometryData(data);
+
+    GeometryStoreEntry *entry = NULL;
+    {
+        std::lock_guard<std::mutex> lock(store->mutex);
+        store->internCount++;
+        entry = findGeometryStoreEntry(store, hash, data);
+        if (entry != NULL) {
+            entry->references++;
+            store->referenceCount++;
+            store->hitCount++;
+        }
+        else {
+            if (data->ownership == GeometryDataBorrowed) { makeGeometryDataResizable(data); }
+            entry = addGeometryStoreEntry(store, hash, *data);
+            *data = createGeometryData();
+        }
+    }
+
+    // a stored match makes the caller's copy redundant
+    freeGeometryData(data);
+    return entry;
+}
+
+GeometryStoreEntry *internGeometryDataCopy(GeometryStore *store, const GeometryData *data)
+{
+    const uint64_t hash = hashGeometryData(data);
+
+    std::lock_guard<std::mutex> lock(store->mutex);
+    store->internCount++;
+    GeometryStoreEntry *entry = findGeometryStoreEntry(store, hash, data);
+    if (entry != NULL) {
+        entry->references++;
+        store->referenceCount++;
+        store->hitCount++;
+        return entry;
+    }
+
+    GeometryData copy = createGeometryData();
+    copyGeometryData(&copy, (GeometryData *)data);
+    return addGeometryStoreEntry(store, hash, copy);
+}
+
+void retainGeometryStoreEntry(GeometryStoreEntry *entry)
+{
+    GeometryStore *store = entry->store;
+    std::lock_guard<std::mutex> lock(store->mutex);
+    entry->references++;
+    store->referenceCount++;
+}
+
+void releaseGeometryStoreEntry(GeometryStoreEntry *entry)
+{
+    GeometryStore *store = entry->store;
+    {
+        std::lock_guard<std::mutex> lock(store->mutex);
+        store->referenceCount--;
+        if (--entry->references > 0) { return; }
+
+        auto range = store->entries.equal_range(entry->hash);
+        for (auto it = range.first; it != range.second; it++) {
+            if (it->second == entry) {
+                store->entries.erase(it);
+                break;
+            }
+        }
+    }
+    freeGeometryStoreEntry(entry);
+}
+
+GeometryData getGeometryStoreEntryData(const GeometryStoreEntry *entry)
+{
+    const GeometryData *data = &entry->geometry;
+    return createGeometryDataWithStorage(data->vertexData, data->vertexCount, data->indexData,
+                                         data->indexCount, NULL, NULL);
+}
+
+uint64_t getGeometryStoreEntryHash(const GeometryStoreEntry *entry) { return entry->hash; }
+
+int getGeometryStoreEntryReferenceCount(const GeometryStoreEntry *entry)
+{
+    std::lock_guard<std::mutex> lock(entry->store->mutex);
+    return entry->references;
+}
+
+Bounds getGeometryStoreEntryBounds(GeometryStoreEntry *entry)
+{
+    std::call_once(entry->boundsOnce, [entry] {
+        entry->bounds =
+            computeBoundsFromVertices(entry->geometry.vertexData, entry->geometry.vertexCount);
+    });
+    return entry->bounds;
+}
+
+const BVH *getGeometryStoreEntryBVH(GeometryStoreEntry *entry)
+{
+    GeometryStore *store = entry->store;
+    store->bvhRequestCount.fetch_add(1, std::memory_order_relaxed);
+    std::call_once(entry->bvhOnce, [entry, store] {
+        const GeometryData *data = &entry->geometry;
+        if (data->indexCount <= 0 && data->vertexCount < 3) { return; }
+        entry->bvh = createBVH(*data, store->useSAH);
+        entry->hasBVH.store(true, std::memory_order_release);
+        store->bvhCount.fetch_add(1, std::memory_order_relaxed);
+    });
+    return &entry->bvh;
+}
+
+GeometryStoreStats getGeometryStoreStats(const GeometryStore *store)
+{
+    std::lock_guard<std::mutex> lock(store->mutex);
+
+    GeometryStoreStats stats = {
+        .entryCount = (int)store->entries.size(),
+        .referenceCount = store->referenceCount,
+        .internCount = store->internCount,
+        .hitCount = store->hitCount,
+        .bvhCount = store->bvhCount.load(std::memory_order_relaxed),
+        .bvhRequestCount = store->bvhRequestCount.load(std::memory_order_relaxed),
+        .uniqueBytes = 0,
+        .referencedBytes = 0,
+        .savedBytes = 0,
+        .dedupRatio = 1.0
+    };
+
+    size_t sharedBVHBytes = 0;
+    for (auto &item : store->entries) {
+        const GeometryStoreEntry *entry = item.second;
+        const size_t bytes = getGeometryDataBytes(&entry->geometry);
+        stats.uniqueBytes += bytes;
+        stats.referencedBytes += bytes * entry->references;
+        if (entry->hasBVH.load(std::memory_order_acquire)) {
+            sharedBVHBytes += getGeometryStoreEntryBVHBytes(entry) * (entry->references - 1);
+        }
+    }
+
+    stats.savedBytes = stats.referencedBytes - stats.uniqueBytes + sharedBVHBytes;
+    if (stats.uniqueBytes > 0) {
+        stats.dedupRatio = (float)((double)stats.referencedBytes / (double)stats.uniqueBytes);
+    }
+    return stats;
+}
@@ -14,3 +14,11 @@ simd_float3 hermite3(simd_float3 m0, simd_float3 a, simd_float3 b, simd_float3 m
     return (2 * t3 - 3 * t2 + 1.0) * a + (t3 - 2 * t2 + t) * m0 + (-2 * t3 + 3 * t2) * b +
            (t3 - t2) * m1;
 }
+
+simd_float3 hermiteVelocity3(simd_float3 m0, simd_float3 a, simd_float3 b, simd_float3 m1,
+                             float t)
+{
+    const float t2 = t * t;
+    return (6 * t2 - 6 * t) * a + (3 * t2 - 4 * t + 1.0) * m0 + (-6 * t2 + 6 * t) * b +
+           (3 * t2 - 2 * t) * m1;
+}
@@ -0,0 +1,388 @@
+//
+//  Jobs.mm
+//  Satin
+//
+//  Created by agent on 10/19/26.
+//
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Jobs.h"
+
+// Every worker owns a deque, it pushes & pops its own jobs LIFO and steals FIFO from the others.
+// Jobs submitted from outside the pool go through a shared injection queue.
+
+struct Job {
+    JobSystem *system;
+    std::function<void()> work;
+    std::function<void()> onCancel;
+    std::atomic<int> status;
+    std::atomic<int> unfinishedDependencies;
+    std::atomic<int> references;
+    std::atomic<bool> dependencyCancelled;
+
+    std::mutex mutex;
+    std::condition_variable finishedCondition;
+    std::vector<Job *> dependents;
+    bool dependentsClosed; // set with the final status, later dependents check it themselves
+    std::atomic<bool> finished; // set once onCancel has run and the dependents were released
+};
+
+// status of a cancelled job while its onCancel runs and its dependents are released
+static const int JobStatusCancelling = JobStatusCancelled + 1;
+
+typedef struct {
+    std::mutex mutex;
+    std::deque<Job *> jobs;
+} JobWorker;
+
+struct JobSystem {
+    std::vector<std::thread> threads;
+    std::vector<std::unique_ptr<JobWorker>> workers;
+
+    std::mutex mutex;
+    std::condition_variable wakeCondition;
+    std::deque<Job *> injected;
+    std::atomic<int> queued;
+    std::atomic<int> waiting; // workers blocked in waitForJob, woken by finishing jobs too
+    bool running;
+};
+
+static thread_local JobSystem *currentJobSystem = NULL;
+static thread_local int currentJobWorker = -1;
+
+static void retainJob(Job *job) { job->references.fetch_add(1, std::memory_order_relaxed); }
+
+void releaseJob(Job *job)
+{
+    if (job != NULL && job->references.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        delete job;
+    }
+}
+
+/* Scheduling */
+
+static void scheduleJob(Job *job)
+{
+    JobSystem *system = job->system;
+    // the queue holds its own reference so cancelled jobs can still be popped safely
+    retainJob(job);
+    if (currentJobSystem == system && currentJobWorker >= 0) {
+        JobWorker *worker = system->workers[currentJobWorker].get();
+        std::lock_guard<std::mutex> lock(worker->mutex);
+        worker->jobs.push_back(job);
+    }
+    else {
+        std::lock_guard<std::mutex> lock(system->mutex);
+        system->injected.push_back(job);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(system->mutex);
+        system->queued.fetch_add(1, std::memory_order_relaxed);
+    }
+    system->wakeCondition.notify_one();
+}
+
+static Job *popJob(JobSystem *system, int workerIndex)
+{
+    Job *job = NULL;
+    const int workerCount = (int)system->workers.size();
+
+    if (workerIndex >= 0) {
+        JobWorker *worker = system->workers[workerIndex].get();
+        std::lock_guard<std::mutex> lock(worker->mutex);
+        if (!worker->jobs.empty()) {
+            job = worker->jobs.back();
+            worker->jobs.pop_back();
+        }
+    }
+
+    if (job == NULL) {
+        std::lock_guard<std::mutex> lock(system->mutex);
+        if (!system->injected.empty()) {
+            job = system->injected.front();
+            system->injected.pop_front();
+        }
+    }
+
+    for (int i = 1; job == NULL && i <= workerCount; i++) {
+        JobWorker *victim = system->workers[(workerIndex + i + workerCount) % workerCount].get();
+        std::lock_guard<std::mutex> lock(victim->mutex);
+        if (!victim->jobs.empty()) {
+            job = victim->jobs.front();
+            victim->jobs.pop_front();
+        }
+    }
+
+    if (job != NULL) { system->queued.fetch_sub(1, std::memory_order_relaxed); }
+    return job;
+}
+
+static void resolveJob(Job *job);
+
+static void finishJob(Job *job, JobStatus status)
+{
+    std::function<void()> onCancel;
+    onCancel.swap(job->onCancel);
+    job->work = nullptr;
+    if (status == JobStatusCancelled && onCancel) { onCancel(); }
+    onCancel = nullptr;
+
+    std::vector<Job *> dependents;
+    {
+        std::lock_guard<std::mutex> lock(job->mutex);
+        job->status.store(status, std::memory_order_release);
+        job->dependentsClosed = true;
+        dependents.swap(job->dependents);
+    }
+
+    for (Job *dependent : dependents) {
+        if (status == JobStatusCancelled) { dependent->dependencyCancelled.store(true); }
+        if (dependent->unfinishedDependencies.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            resolveJob(dependent);
+        }
+        releaseJob(dependent);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(job->mutex);
+        job->finished.store(true);
+    }
+    job->finishedCondition.notify_all();
+
+    JobSystem *system = job->system;
+    if (system->waiting.load() > 0) {
+        { std::lock_guard<std::mutex> lock(system->mutex); }
+        system->wakeCondition.notify_all();
+    }
+
+    // the reference the system held while the job was outstanding
+    releaseJob(job);
+}
+
+static void resolveJob(Job *job)
+{
+    int expected = JobStatusPending;
+    if (job->dependencyCancelled.load()) {
+        if (job->status.compare_exchange_strong(expected, JobStatusCancelling)) {
+            finishJob(job, JobStatusCancelled);
+        }
+    }
+    else if (job->status.compare_exchange_strong(expected, JobStatusQueued)) {
+        scheduleJob(job);
+    }
+}
+
+static void runJob(Job *job)
+{
+    int expected = JobStatusQueued;
+    if (job->status.compare_exchange_strong(expected, JobStatusRunning)) {
+        if (job->work) { job->work(); }
+        finishJob(job, JobStatusCompleted);
+    }
+    releaseJob(job);
+}
+
+static void runJobWorker(JobSystem *system, int workerIndex)
+{
+    currentJobSystem = system;
+    currentJobWorker = workerIndex;
+
+    while (true) {
+        Job *job = popJob(system, workerIndex);
+        if (job != NULL) {
+            runJob(job);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(system->mutex);
+        system->wakeCondition.wait(lock, [system] {
+            return system->queued.load(std::memory_order_relaxed) > 0 || !system->running;
+        });
+        if (!system->running && system->queued.load(std::memory_order_relaxed) == 0) { break; }
+    }
+
+    currentJobSystem = NULL;
+    currentJobWorker = -1;
+}
+
+/* System */
+
+JobSystem *createJobSystem(int threadCount)
+{
+    if (threadCount <= 0) {
+        threadCount = (int)std::thread::hardware_concurrency() - 1;
+        if (threadCount < 1) { threadCount = 1; }
+    }
+
+    JobSystem *system = new JobSystem();
+    system->queued.store(0);
+    system->waiting.store(0);
+    system->running = true;
+    for (int i = 0; i < threadCount; i++) {
+        system->workers.emplace_back(new JobWorker());
+    }
+    for (int i = 0; i < threadCount; i++) {
+        system->threads.emplace_back(runJobWorker, system, i);
+    }
+    return system;
+}
+
+void freeJobSystem(JobSystem *system)
+{
+    {
+        std::lock_guard<std::mutex> lock(system->mutex);
+        system->running = false;
+    }
+    system->wakeCondition.notify_all();
+    for (std::thread &thread : system->threads) {
+        thread.join();
+    }
+    delete system;
+}
+
+int getJobSystemThreadCount(const JobSystem *system) { return (int)system->threads.size(); }
+
+/* Jobs */
+
+Job *submitJobClosure(JobSystem *system, std::function<void()> work,
+                      std::function<void()> onCancel, Job **dependencies, int dependencyCount)
+{
+    Job *job = new Job();
+    job->system = system;
+    job->work = std::move(work);
+    job->onCancel = std::move(onCancel);
+    job->status.store(JobStatusPending);
+    // one reference for the caller's handle, one for the system until the job finishes
+    job->references.store(2);
+    // guard count so the job can't be resolved while dependencies are still being added
+    job->unfinishedDependencies.store(1);
+    job->dependencyCancelled.store(false);
+    job->dependentsClosed = false;
+    job->finished.store(false);
+
+    for (int i = 0; i < dependencyCount; i++) {
+        Job *dependency = dependencies[i];
+        if (dependency == NULL) { continue; }
+        std::lock_guard<std::mutex> lock(dependency->mutex);
+        if (dependency->dependentsClosed) {
+            if (dependency->status.load() == JobStatusCancelled) {
+                job->dependencyCancelled.store(true);
+            }
+        }
+        else {
+            job->unfinishedDependencies.fetch_add(1);
+            retainJob(job);
+            dependency->dependents.push_back(job);
+        }
+    }
+
+    if (job->unfinishedDependencies.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        resolveJob(job);
+    }
+    return job;
+}
+
+Job *submitJob(JobSystem *system, JobFunction function, void *context, Job **dependencies,
+               int dependencyCount)
+{
+    return submitJobClosure(
+        system, [function, context] { function(context); }, nullptr, dependencies,
+        dependencyCount);
+}
+
+void waitForJob(Job *job)
+{
+    JobSystem *system = job->system;
+    if (currentJobSystem == system && currentJobWorker >= 0) {
+        // help out instead of blocking a worker the job might depend on, sleep when there's
+        // nothing to run until either more work is queued or the job finishes
+        while (!isJobFinished(job)) {
+            Job *other = popJob(system, currentJobWorker);
+            if (other != NULL) {
+                runJob(other);
+                continue;
+            }
+
+            system->waiting.fetch_add(1);
+            {
+                std::unique_lock<std::mutex> lock(system->mutex);
+                system->wakeCondition.wait(lock, [system, job] {
+                    return isJobFinished(job) ||
+                           system->queued.load(std::memory_order_relaxed) > 0;
+                });
+            }
+            system->waiting.fetch_sub(1);
+        }
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(job->mutex);
+    job->finishedCondition.wait(lock, [job] { return job->finished.load(); });
+}
+
+void waitForJobs(Job **jobs, int count)
+{
+    for (int i = 0; i < count; i++) {
+        if (jobs[i] != NULL) { waitForJob(jobs[i]); }
+    }
+}
+
+bool isJobFinished(Job *job) { return job->finished.load(); }
+
+JobStatus getJobStatus(Job *job)
+{
+    // the final status is only reported once the job has finished cleaning up
+    const int status = job->status.load(std::memory_order_acquire);
+    if (status >= JobStatusCompleted && !job->finished.load()) { return JobStatusRunning; }
+    return (JobStatus)status;
+}
+
+bool cancelJob(Job *job)
+{
+    int expected = JobStatusPending;
+    if (!job->status.compare_exchange_strong(expected, JobStatusCancelling)) {
+        expected = JobStatusQueued;
+        if (!job->status.compare_exchange_strong(expected, JobStatusCancelling)) { return false; }
+    }
+    finishJob(job, JobStatusCancelled);
+    return true;
+}
+
+void parallelFor(JobSystem *system, int count, int grainSize,
+                 const std::function<void(int begin, int end)> &body)
+{
+    if (count <= 0) { return; }
+
+    // a few chunks per thread so uneven chunks can be balanced by stealing
+    const int64_t grain = grainSize > 0 ? grainSize : 1;
+    const int64_t threads = system != NULL ? getJobSystemThreadCount(system) + 1 : 1;
+    const int64_t chunks = std::min((count + grain - 1) / grain, threads * 4);
+    if (system == NULL || chunks <= 1) {
+        body(0, count);
+        return;
+    }
+
+    const int chunkSize = (int)((count + chunks - 1) / chunks);
+    std::vector<Job *> jobs;
+    for (int64_t start = chunkSize; start < count; start += chunkSize) {
+        const int begin = (int)start;
+        const int end = (int)std::min<int64_t>(start + chunkSize, count);
+        jobs.push_back(submitJobClosure(
+            system, [&body, begin, end] { body(begin, end); }, nullptr, NULL, 0));
+    }
+    body(0, chunkSize);
+
+    waitForJobs(jobs.data(), (int)jobs.size());
+    for (Job *job : jobs) {
+        releaseJob(job);
+    }
+}
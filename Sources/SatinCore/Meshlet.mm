@@ -0,0 +1,318 @@
+//
+//  Meshlet.mm
+//  Satin
+//
+//  Created by agent on 10/19/26.
+//
+
+#include <algorithm>
+#include <float.h>
+#include <malloc/_malloc.h>
+#include <vector>
+
+#include "Bounds.h"
+#include "Meshlet.h"
+#include "Profiler.h"
+
+static inline simd_float3 meshletPosition(const GeometryData *geometry, uint32_t index)
+{
+    return simd_make_float3(geometry->vertexData[index].position);
+}
+
+static inline uint32_t getTriangleIndex(const TriangleIndices *tri, int corner)
+{
+    return corner == 0 ? tri->i0 : (corner == 1 ? tri->i1 : tri->i2);
+}
+
+static inline void setMeshletIndex(void *triangles, int indexSize, uint32_t offset, uint32_t value)
+{
+    if (indexSize == 1) { ((uint8_t *)triangles)[offset] = (uint8_t)value; }
+    else {
+        ((uint16_t *)triangles)[offset] = (uint16_t)value;
+    }
+}
+
+static uint32_t getMeshletIndex(const MeshletData *data, uint32_t offset)
+{
+    return data->indexSize == 1 ? ((const uint8_t *)data->triangles)[offset]
+                                : ((const uint16_t *)data->triangles)[offset];
+}
+
+// Unit face normal of a meshlet's triangle, zero when degenerate
+static simd_float3 getMeshletFaceNormal(const GeometryData *geometry, const MeshletData *data,
+                                        const Meshlet *meshlet, uint32_t triangle)
+{
+    const uint32_t *vertices = data->vertices + meshlet->vertexOffset;
+    const uint32_t offset = (meshlet->triangleOffset + triangle) * 3;
+    const simd_float3 p0 = meshletPosition(geometry, vertices[getMeshletIndex(data, offset)]);
+    const simd_float3 p1 = meshletPosition(geometry, vertices[getMeshletIndex(data, offset + 1)]);
+    const simd_float3 p2 = meshletPosition(geometry, vertices[getMeshletIndex(data, offset + 2)]);
+    const simd_float3 n = simd_cross(p1 - p0, p2 - p0);
+    const float len = simd_length(n);
+    return len > FLT_EPSILON ? n / len : simd_make_float3(0.0, 0.0, 0.0);
+}
+
+static void computeMeshletBounds(const GeometryData *geometry, const MeshletData *data,
+                                 Meshlet *meshlet)
+{
+    const uint32_t *vertices = data->vertices + meshlet->vertexOffset;
+
+    Bounds bounds = createBounds();
+    for (uint32_t i = 0; i < meshlet->vertexCount; i++) {
+        bounds = expandBounds(bounds, meshletPosition(geometry, vertices[i]));
+    }
+
+    const simd_float3 center = (bounds.min + bounds.max) * 0.5;
+    float radius2 = 0.0;
+    for (uint32_t i = 0; i < meshlet->vertexCount; i++) {
+        radius2 = std::max(radius2,
+                           simd_distance_squared(center, meshletPosition(geometry, vertices[i])));
+    }
+
+    // normal cone around the average face normal
+    simd_float3 axis = 0.0;
+    for (uint32_t i = 0; i < meshlet->triangleCount; i++) {
+        axis += getMeshletFaceNormal(geometry, data, meshlet, i);
+    }
+
+    float cutoff = 1.0;
+    const float axisLength = simd_length(axis);
+    if (axisLength > FLT_EPSILON) {
+        axis /= axisLength;
+        float minDot = 1.0;
+        for (uint32_t i = 0; i < meshlet->triangleCount; i++) {
+            const simd_float3 n = getMeshletFaceNormal(geometry, data, meshlet, i);
+            if (simd_length_squared(n) > 0.0) { minDot = std::min(minDot, simd_dot(axis, n)); }
+        }
+        // sin of the cone's half angle, a cone wider than a hemisphere can't cull anything
+        if (minDot > 0.0) { cutoff = sqrtf(1.0 - minDot * minDot); }
+    }
+    else {
+        axis = simd_make_float3(0.0, 0.0, 1.0);
+    }
+
+    meshlet->bounds = bounds;
+    meshlet->sphere = simd_make_float4(center, sqrtf(radius2));
+    meshlet->cone = simd_make_float4(axis, cutoff);
+}
+
+MeshletData buildMeshlets(const GeometryData *geometry, int maxVertices, int maxTriangles,
+                          int indexSize)
+{
+    ProfileSpan span(__func__);
+
+    indexSize = indexSize == 1 ? 1 : 2;
+    maxVertices = std::min(std::max(maxVertices, 3), indexSize == 1 ? 256 : 65536);
+    maxTriangles = std::max(maxTriangles, 1);
+
+    const int vertexCount = geometry->vertexCount;
+    const int triangleCount = geometry->indexCount;
+    const TriangleIndices *indices = geometry->indexData;
+
+    MeshletData data = { .meshletCount = 0,
+                         .meshlets = NULL,
+                         .vertexCount = 0,
+                         .vertices = NULL,
+                         .triangleCount = 0,
+                         .indexSize = indexSize,
+                         .triangles = NULL };
+    if (triangleCount <= 0 || vertexCount <= 0) { return data; }
+
+    // vertex to triangle adjacency
+    std::vector<uint32_t> adjacencyOffsets(vertexCount + 1, 0);
+    std::vector<uint32_t> adjacency(triangleCount * 3);
+    for (int i = 0; i < triangleCount; i++) {
+        for (int c = 0; c < 3; c++) {
+            adjacencyOffsets[getTriangleIndex(&indices[i], c) + 1]++;
+        }
+    }
+    for (int i = 0; i < vertexCount; i++) {
+        adjacencyOffsets[i + 1] += adjacencyOffsets[i];
+    }
+    std::vector<uint32_t> adjacencyFill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+    for (int i = 0; i < triangleCount; i++) {
+        for (int c = 0; c < 3; c++) {
+            adjacency[adjacencyFill[getTriangleIndex(&indices[i], c)]++] = i;
+        }
+    }
+    adjacencyFill.clear();
+    adjacencyFill.shrink_to_fit();
+
+    // worst case sizes, trimmed at the end
+    data.meshlets = (Meshlet *)malloc(triangleCount * sizeof(Meshlet));
+    data.vertices = (uint32_t *)malloc(triangleCount * 3 * sizeof(uint32_t));
+    data.triangles = malloc(triangleCount * 3 * indexSize);
+
+    std::vector<uint8_t> used(triangleCount, 0);
+    std::vector<int> candidateStamp(triangleCount, -1);
+    std::vector<int> local(vertexCount, -1);
+    std::vector<uint32_t> candidates;
+
+    int scan = 0;
+    int seed = -1;
+    int emitted = 0;
+    while (emitted < triangleCount) {
+        if (seed < 0) {
+            while (used[scan]) {
+                scan++;
+            }
+            seed = scan;
+        }
+
+        const int meshletIndex = data.meshletCount++;
+        Meshlet *meshlet = &data.meshlets[meshletIndex];
+        meshlet->vertexOffset = data.vertexCount;
+        meshlet->vertexCount = 0;
+        meshlet->triangleOffset = data.triangleCount;
+        meshlet->triangleCount = 0;
+
+        simd_float3 centroidSum = 0.0;
+        candidates.clear();
+
+        int next = seed;
+        while (next >= 0) {
+            const TriangleIndices *tri = &indices[next];
+            used[next] = 1;
+            emitted++;
+
+            for (int c = 0; c < 3; c++) {
+                const uint32_t v = getTriangleIndex(tri, c);
+                if (local[v] < 0) {
+                    local[v] = meshlet->vertexCount++;
+                    data.vertices[data.vertexCount++] = v;
+                    centroidSum += meshletPosition(geometry, v);
+
+                    for (uint32_t a = adjacencyOffsets[v]; a < adjacencyOffsets[v + 1]; a++) {
+                        const uint32_t t = adjacency[a];
+                        if (!used[t] && candidateStamp[t] != meshletIndex) {
+                            candidateStamp[t] = meshletIndex;
+                            candidates.push_back(t);
+                        }
+                    }
+                }
+                setMeshletIndex(data.triangles, indexSize, data.triangleCount * 3 + c, local[v]);
+            }
+            data.triangleCount++;
+            meshlet->triangleCount++;
+
+            if ((int)meshlet->triangleCount >= maxTriangles) { break; }
+
+            // prefer triangles that add the fewest vertices, then the ones closest to the centroid
+            const simd_float3 centroid = centroidSum / (float)meshlet->vertexCount;
+            next = -1;
+            int bestNew = 4;
+            float bestDistance = FLT_MAX;
+            size_t write = 0;
+            for (size_t i = 0; i < candidates.size(); i++) {
+                const uint32_t t = candidates[i];
+                if (used[t]) { continue; }
+                candidates[write++] = t;
+
+                const TriangleIndices *candidate = &indices[t];
+                const int newVertices = (local[candidate->i0] < 0) + (local[candidate->i1] < 0) +
+                                        (local[candidate->i2] < 0);
+                if ((int)meshlet->vertexCount + newVertices > maxVertices) { continue; }
+                if (newVertices > bestNew) { continue; }
+
+                const simd_float3 center = (meshletPosition(geometry, candidate->i0) +
+                                            meshletPosition(geometry, candidate->i1) +
+                                            meshletPosition(geometry, candidate->i2)) /
+                                           3.0;
+                const float distance = simd_distance_squared(center, centroid);
+                if (newVertices < bestNew || distance < bestDistance) {
+                    next = t;
+                    bestNew = newVertices;
+                    bestDistance = distance;
+                }
+            }
+            candidates.resize(write);
+        }
+
+        computeMeshletBounds(geometry, &data, meshlet);
+
+        // the next cluster starts on this one's border to keep neighbouring clusters close
+        seed = -1;
+        for (uint32_t t : candidates) {
+            if (!used[t]) {
+                seed = t;
+                break;
+            }
+        }
+
+        for (uint32_t i = 0; i < meshlet->vertexCount; i++) {
+            local[data.vertices[meshlet->vertexOffset + i]] = -1;
+        }
+    }
+
+    data.meshlets = (Meshlet *)realloc(data.meshlets, data.meshletCount * sizeof(Meshlet));
+    data.vertices = (uint32_t *)realloc(data.vertices, data.vertexCount * sizeof(uint32_t));
+
+    addProfileCounter(ProfileCounterMeshletsBuilt, data.meshletCount);
+    span.setGeometry(data.vertexCount, data.triangleCount);
+    return data;
+}
+
+void freeMeshletData(MeshletData *data)
+{
+    if (data->meshlets != NULL) { free(data->meshlets); }
+    if (data->vertices != NULL) { free(data->vertices); }
+    if (data->triangles != NULL) { free(data->triangles); }
+    data->meshlets = NULL;
+    data->vertices = NULL;
+    data->triangles = NULL;
+    data->meshletCount = 0;
+    data->vertexCount = 0;
+    data->triangleCount = 0;
+}
+
+void extractFrustumPlanes(simd_float4x4 viewProjection, simd_float4 *planes)
+{
+    const simd_float4x4 m = simd_transpose(viewProjection);
+    const simd_float4 row0 = m.columns[0];
+    const simd_float4 row1 = m.columns[1];
+    const simd_float4 row2 = m.columns[2];
+    const simd_float4 row3 = m.columns[3];
+
+    planes[0] = row3 + row0; // left
+    planes[1] = row3 - row0; // right
+    planes[2] = row3 + row1; // bottom
+    planes[3] = row3 - row1; // top
+    planes[4] = row2;        // near
+    planes[5] = row3 - row2; // far
+
+    for (int i = 0; i < 6; i++) {
+        planes[i] /= simd_length(simd_make_float3(planes[i]));
+    }
+}
+
+int cullMeshlets(const MeshletData *data, const simd_float4 *planes, int planeCount,
+                 simd_float3 cameraPosition, uint32_t *visible)
+{
+    // without planes only the normal cones are tested
+    if (planes == NULL) { planeCount = 0; }
+
+    int count = 0;
+    for (int i = 0; i < data->meshletCount; i++) {
+        const Meshlet *meshlet = &data->meshlets[i];
+        const simd_float3 center = simd_make_float3(meshlet->sphere);
+        const float radius = meshlet->sphere.w;
+
+        bool inside = true;
+        for (int p = 0; p < planeCount && inside; p++) {
+            inside = simd_dot(simd_make_float3(planes[p]), center) + planes[p].w >= -radius;
+        }
+        if (!inside) { continue; }
+
+        // every triangle faces away when the camera sits inside the cone's back side
+        const simd_float3 view = center - cameraPosition;
+        const float cutoff = meshlet->cone.w;
+        const float facing = simd_dot(view, simd_make_float3(meshlet->cone));
+        if (cutoff < 1.0 && facing >= cutoff * simd_length(view) + radius) {
+            continue;
+        }
+
+        visible[count++] = i;
+    }
+    addProfileCounter(ProfileCounterMeshletsCulled, data->meshletCount - count);
+    return count;
+}
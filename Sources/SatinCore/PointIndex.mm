@@ -0,0 +1,797 @@
+//
+//  PointIndex.mm
+//  Satin
+//
+//  Created by agent on 10/19/26.
+//
+
+#include <algorithm>
+#include <atomic>
+#include <limits.h>
+#include <math.h>
+#include <mutex>
+#include <string.h>
+#include <vector>
+
+#include "Bounds.h"
+#include "PointIndex.h"
+#include "Profiler.h"
+
+// Both indices keep their own copy of the points as simd_float4s with the point's id in w, so
+// reordering the points carries the ids along and scanning them stays in cache
+
+#define KDTREE_LEAF_SIZE 16
+// Subtrees with at least this many points are built or refit on another worker
+#define KDTREE_PARALLEL_SIZE 32768
+// Deeper than any tree addressable with int indices
+#define KDTREE_STACK_SIZE 64
+
+#define POINT_INDEX_GRAIN 16384
+#define POINT_INDEX_QUERY_GRAIN 64
+
+static inline simd_float4 makeIndexedPoint(simd_float3 position, uint32_t id)
+{
+    float w;
+    memcpy(&w, &id, sizeof(float));
+    return simd_make_float4(position, w);
+}
+
+static inline uint32_t getIndexedPointId(simd_float4 point)
+{
+    const float w = point.w;
+    uint32_t id;
+    memcpy(&id, &w, sizeof(uint32_t));
+    return id;
+}
+
+static inline simd_float3 readPosition(const void *positions, uint32_t stride, int64_t index)
+{
+    const float *position = (const float *)((const char *)positions + index * stride);
+    return simd_make_float3(position[0], position[1], position[2]);
+}
+
+static void copyIndexedPoints(std::vector<simd_float4> &points, const void *positions,
+                              uint32_t positionStride, int count, JobSystem *system)
+{
+    points.resize(count);
+    simd_float4 *data = points.data();
+    parallelFor(system, count, POINT_INDEX_GRAIN, [=](int begin, int end) {
+        for (int i = begin; i < end; i++) {
+            data[i] = makeIndexedPoint(readPosition(positions, positionStride, i), i);
+        }
+    });
+}
+
+static inline float getBoundsDistanceSquared(const Bounds &bounds, simd_float3 point)
+{
+    const simd_float3 zero = 0.0;
+    return simd_length_squared(simd_max(simd_max(bounds.min - point, point - bounds.max), zero));
+}
+
+static inline Bounds unionBounds(const Bounds &a, const Bounds &b)
+{
+    return (Bounds) { .min = simd_min(a.min, b.min), .max = simd_max(a.max, b.max) };
+}
+
+static Bounds computePointBounds(const simd_float4 *points, int begin, int end)
+{
+    Bounds bounds = createBounds();
+    for (int i = begin; i < end; i++) {
+        const simd_float3 p = simd_make_float3(points[i]);
+        bounds.min = simd_min(bounds.min, p);
+        bounds.max = simd_max(bounds.max, p);
+    }
+    return bounds;
+}
+
+// The k nearest are kept sorted by squared distance in the caller's buffers, limit is the squared
+// distance a candidate has to be within
+
+typedef struct {
+    uint32_t *ids;
+    float *distances;
+    int capacity;
+    int count;
+    float limit;
+} NearestSet;
+
+static NearestSet makeNearestSet(uint32_t *results, float *distances, int k, float maxDistance)
+{
+    thread_local std::vector<float> scratch;
+    if (distances == NULL) {
+        if ((int)scratch.size() < k) { scratch.resize(k); }
+        distances = scratch.data();
+    }
+    const float limit = std::max(maxDistance, 0.0f);
+    return (NearestSet) {
+        .ids = results, .distances = distances, .capacity = k, .count = 0, .limit = limit * limit
+    };
+}
+
+static inline void insertNearest(NearestSet *set, uint32_t id, float distance)
+{
+    if (distance > set->limit) { return; }
+
+    int i = set->count;
+    if (set->count < set->capacity) { set->count++; }
+    else {
+        if (distance >= set->distances[set->capacity - 1]) { return; }
+        i = set->capacity - 1;
+    }
+
+    while (i > 0 && set->distances[i - 1] > distance) {
+        set->distances[i] = set->distances[i - 1];
+        set->ids[i] = set->ids[i - 1];
+        i--;
+    }
+    set->distances[i] = distance;
+    set->ids[i] = id;
+
+    if (set->count == set->capacity) {
+        set->limit = std::min(set->limit, set->distances[set->capacity - 1]);
+    }
+}
+
+static int finishNearest(const NearestSet *set, float *distances)
+{
+    if (distances != NULL) {
+        for (int i = 0; i < set->count; i++) {
+            distances[i] = sqrtf(distances[i]);
+        }
+    }
+    return set->count;
+}
+
+typedef struct {
+    uint32_t *ids;
+    float *distances;
+    int capacity;
+    int count;
+} RadiusSet;
+
+static inline void addRadiusResult(RadiusSet *set, uint32_t id, float distance)
+{
+    if (set->count < set->capacity) {
+        set->ids[set->count] = id;
+        if (set->distances != NULL) { set->distances[set->count] = sqrtf(distance); }
+    }
+    set->count++;
+}
+
+// K-d tree
+
+struct KdTree {
+    std::vector<simd_float4> points; // leaf order
+    std::vector<uint32_t> slots;     // id -> index into points
+    // complete tree, the children of node i are 2i + 1 and 2i + 2 and a node's points are split
+    // in half (the left child gets the smaller half) so ranges don't have to be stored
+    std::vector<Bounds> nodes;
+    int depth; // of the leaves
+};
+
+typedef struct {
+    uint32_t node;
+    int begin;
+    int end;
+    float distance;
+} KdTreeStackEntry;
+
+static int getKdTreeDepth(int count)
+{
+    int depth = 0;
+    while ((((int64_t)count + ((int64_t)1 << depth) - 1) >> depth) > KDTREE_LEAF_SIZE) {
+        depth++;
+    }
+    return depth;
+}
+
+// cell is the region the node splits (its parent's cell cut at the median), the node bounds are
+// computed bottom up from the leaves
+static void buildKdTreeNode(KdTree *tree, JobSystem *system, uint32_t node, int depth, int begin,
+                            int end, Bounds cell)
+{
+    simd_float4 *points = tree->points.data();
+    if (depth == tree->depth) {
+        tree->nodes[node] = computePointBounds(points, begin, end);
+        return;
+    }
+
+    const simd_float3 extent = cell.max - cell.min;
+    const int axis =
+        extent.x >= extent.y && extent.x >= extent.z ? 0 : (extent.y >= extent.z ? 1 : 2);
+    const int mid = begin + (end - begin) / 2;
+    std::nth_element(points + begin, points + mid, points + end,
+                     [axis](simd_float4 a, simd_float4 b) { return a[axis] < b[axis]; });
+
+    Bounds leftCell = cell;
+    Bounds rightCell = cell;
+    leftCell.max[axis] = points[mid][axis];
+    rightCell.min[axis] = points[mid][axis];
+
+    const uint32_t left = node * 2 + 1;
+    if (system != NULL && end - begin >= KDTREE_PARALLEL_SIZE) {
+        Job *job = submitJobClosure(
+            system,
+            [=] { buildKdTreeNode(tree, system, left, depth + 1, begin, mid, leftCell); },
+            nullptr, NULL, 0);
+        buildKdTreeNode(tree, system, left + 1, depth + 1, mid, end, rightCell);
+        waitForJob(job);
+        releaseJob(job);
+    }
+    else {
+        buildKdTreeNode(tree, system, left, depth + 1, begin, mid, leftCell);
+        buildKdTreeNode(tree, system, left + 1, depth + 1, mid, end, rightCell);
+    }
+
+    tree->nodes[node] = unionBounds(tree->nodes[left], tree->nodes[left + 1]);
+}
+
+static void refitKdTreeNode(KdTree *tree, JobSystem *system, uint32_t node, int depth, int begin,
+                            int end)
+{
+    if (depth == tree->depth) {
+        tree->nodes[node] = computePointBounds(tree->points.data(), begin, end);
+        return;
+    }
+
+    const int mid = begin + (end - begin) / 2;
+    const uint32_t left = node * 2 + 1;
+    if (system != NULL && end - begin >= KDTREE_PARALLEL_SIZE) {
+        Job *job = submitJobClosure(
+            system, [=] { refitKdTreeNode(tree, system, left, depth + 1, begin, mid); }, nullptr,
+            NULL, 0);
+        refitKdTreeNode(tree, system, left + 1, depth + 1, mid, end);
+        waitForJob(job);
+        releaseJob(job);
+    }
+    else {
+        refitKdTreeNode(tree, system, left, depth + 1, begin, mid);
+        refitKdTreeNode(tree, system, left + 1, depth + 1, mid, end);
+    }
+
+    tree->nodes[node] = unionBounds(tree->nodes[left], tree->nodes[left + 1]);
+}
+
+static void buildKdTree(KdTree *tree, JobSystem *system)
+{
+    const int count = (int)tree->points.size();
+    tree->depth = getKdTreeDepth(count);
+    tree->nodes.assign(((size_t)2 << tree->depth) - 1, createBounds());
+    tree->slots.resize(count);
+    if (count == 0) { return; }
+
+    simd_float4 *points = tree->points.data();
+    Bounds cell = createBounds();
+    std::mutex mutex;
+    parallelFor(system, count, POINT_INDEX_GRAIN, [&](int begin, int end) {
+        const Bounds bounds = computePointBounds(points, begin, end);
+        std::lock_guard<std::mutex> lock(mutex);
+        cell = unionBounds(cell, bounds);
+    });
+
+    buildKdTreeNode(tree, system, 0, 0, 0, count, cell);
+
+    uint32_t *slots = tree->slots.data();
+    parallelFor(system, count, POINT_INDEX_GRAIN, [=](int begin, int end) {
+        for (int i = begin; i < end; i++) {
+            slots[getIndexedPointId(points[i])] = i;
+        }
+    });
+}
+
+KdTree *createKdTree(const void *positions, uint32_t positionStride, int count,
+                     JobSystem *system)
+{
+    ProfileSpan span(__func__);
+    KdTree *tree = new KdTree();
+    copyIndexedPoints(tree->points, positions, positionStride, std::max(count, 0), system);
+    buildKdTree(tree, system);
+    span.setGeometry(getKdTreeCount(tree), 0);
+    return tree;
+}
+
+KdTree *createKdTreeFromGeometry(const GeometryData *geometry, JobSystem *system)
+{
+    return createKdTree(geometry->vertexData, sizeof(Vertex), geometry->vertexCount, system);
+}
+
+void freeKdTree(KdTree *tree) { delete tree; }
+
+void rebuildKdTree(KdTree *tree, JobSystem *system)
+{
+    ProfileSpan span(__func__);
+    buildKdTree(tree, system);
+    span.setGeometry(getKdTreeCount(tree), 0);
+}
+
+int getKdTreeCount(const KdTree *tree) { return (int)tree->points.size(); }
+
+Bounds getKdTreeBounds(const KdTree *tree) { return tree->nodes[0]; }
+
+simd_float3 getKdTreePoint(const KdTree *tree, uint32_t id)
+{
+    return simd_make_float3(tree->points[tree->slots[id]]);
+}
+
+// Refits the leaf holding slot and its ancestors
+static void refitKdTreeSlot(KdTree *tree, uint32_t slot)
+{
+    uint32_t node = 0;
+    int begin = 0;
+    int end = (int)tree->points.size();
+    for (int depth = 0; depth < tree->depth; depth++) {
+        const int mid = begin + (end - begin) / 2;
+        if ((int)slot < mid) {
+            node = node * 2 + 1;
+            end = mid;
+        }
+        else {
+            node = node * 2 + 2;
+            begin = mid;
+        }
+    }
+
+    tree->nodes[node] = computePointBounds(tree->points.data(), begin, end);
+    while (node > 0) {
+        node = (node - 1) / 2;
+        tree->nodes[node] = unionBounds(tree->nodes[node * 2 + 1], tree->nodes[node * 2 + 2]);
+    }
+}
+
+void updateKdTreePoint(KdTree *tree, uint32_t id, simd_float3 position)
+{
+    if (id >= tree->slots.size()) { return; }
+    const uint32_t slot = tree->slots[id];
+    tree->points[slot] = makeIndexedPoint(position, id);
+    refitKdTreeSlot(tree, slot);
+}
+
+void updateKdTreePoints(KdTree *tree, const void *positions, uint32_t positionStride,
+                        const uint32_t *ids, int count, JobSystem *system)
+{
+    const int pointCount = getKdTreeCount(tree);
+    if (ids == NULL) { count = pointCount; }
+    if (count <= 0 || pointCount == 0) { return; }
+
+    // a few points refit their paths, more than that refit the whole tree once
+    if (ids != NULL && (int64_t)count * (tree->depth + 1) < (int64_t)tree->nodes.size()) {
+        for (int i = 0; i < count; i++) {
+            updateKdTreePoint(tree, ids[i], readPosition(positions, positionStride, i));
+        }
+        return;
+    }
+
+    simd_float4 *points = tree->points.data();
+    const uint32_t *slots = tree->slots.data();
+    parallelFor(system, count, POINT_INDEX_GRAIN, [=](int begin, int end) {
+        for (int i = begin; i < end; i++) {
+            const uint32_t id = ids != NULL ? ids[i] : (uint32_t)i;
+            if (id >= (uint32_t)pointCount) { continue; }
+            points[slots[id]] = makeIndexedPoint(readPosition(positions, positionStride, i), id);
+        }
+    });
+    refitKdTreeNode(tree, system, 0, 0, 0, pointCount);
+}
+
+static void searchKdTreeNearest(const KdTree *tree, simd_float3 point, NearestSet *set)
+{
+    const uint32_t firstLeaf = (1u << tree->depth) - 1;
+    const simd_float4 *points = tree->points.data();
+    const Bounds *nodes = tree->nodes.data();
+
+    KdTreeStackEntry stack[KDTREE_STACK_SIZE];
+    int top = 0;
+    stack[top++] = (KdTreeStackEntry) { .node = 0,
+                                        .begin = 0,
+                                        .end = (int)tree->points.size(),
+                                        .distance = getBoundsDistanceSquared(nodes[0], point) };
+
+    while (top > 0) {
+        const KdTreeStackEntry entry = stack[--top];
+        if (entry.distance > set->limit) { continue; }
+
+        if (entry.node >= firstLeaf) {
+            for (int i = entry.begin; i < entry.end; i++) {
+                const simd_float4 p = points[i];
+                insertNearest(set, getIndexedPointId(p),
+                              simd_distance_squared(simd_make_float3(p), point));
+            }
+            continue;
+        }
+
+        const int mid = entry.begin + (entry.end - entry.begin) / 2;
+        const uint32_t left = entry.node * 2 + 1;
+        const KdTreeStackEntry leftEntry = {
+            .node = left,
+            .begin = entry.begin,
+            .end = mid,
+            .distance = getBoundsDistanceSquared(nodes[left], point)
+        };
+        const KdTreeStackEntry rightEntry = {
+            .node = left + 1,
+            .begin = mid,
+            .end = entry.end,
+            .distance = getBoundsDistanceSquared(nodes[left + 1], point)
+        };
+
+        // the nearer child goes on top so it's searched first and tightens the limit
+        const bool leftFirst = leftEntry.distance <= rightEntry.distance;
+        stack[top++] = leftFirst ? rightEntry : leftEntry;
+        stack[top++] = leftFirst ? leftEntry : rightEntry;
+    }
+}
+
+static void searchKdTreeRadius(const KdTree *tree, simd_float3 point, float radius2,
+                               RadiusSet *set)
+{
+    const uint32_t firstLeaf = (1u << tree->depth) - 1;
+    const simd_float4 *points = tree->points.data();
+    const Bounds *nodes = tree->nodes.data();
+
+    KdTreeStackEntry stack[KDTREE_STACK_SIZE];
+    int top = 0;
+    stack[top++] = (KdTreeStackEntry) {
+        .node = 0, .begin = 0, .end = (int)tree->points.size(), .distance = 0.0
+    };
+
+    while (top > 0) {
+        const KdTreeStackEntry entry = stack[--top];
+        if (getBoundsDistanceSquared(nodes[entry.node], point) > radius2) { continue; }
+
+        if (entry.node >= firstLeaf) {
+            for (int i = entry.begin; i < entry.end; i++) {
+                const simd_float4 p = points[i];
+                const float distance = simd_distance_squared(simd_make_float3(p), point);
+                if (distance <= radius2) { addRadiusResult(set, getIndexedPointId(p), distance); }
+            }
+            continue;
+        }
+
+        const int mid = entry.begin + (entry.end - entry.begin) / 2;
+        const uint32_t left = entry.node * 2 + 1;
+        stack[top++] = (KdTreeStackEntry) {
+            .node = left + 1, .begin = mid, .end = entry.end, .distance = 0.0
+        };
+        stack[top++] = (KdTreeStackEntry) {
+            .node = left, .begin = entry.begin, .end = mid, .distance = 0.0
+        };
+    }
+}
+
+int queryKdTreeNearest(const KdTree *tree, simd_float3 point, int k, float maxDistance,
+                       uint32_t *results, float *distances)
+{
+    if (k <= 0 || tree->points.empty()) { return 0; }
+    NearestSet set = makeNearestSet(results, distances, k, maxDistance);
+    searchKdTreeNearest(tree, point, &set);
+    return finishNearest(&set, distances);
+}
+
+int queryKdTreeRadius(const KdTree *tree, simd_float3 point, float radius, uint32_t *results,
+                      float *distances, int capacity)
+{
+    RadiusSet set = { .ids = results, .distances = distances, .capacity = capacity, .count = 0 };
+    if (radius < 0.0 || tree->points.empty()) { return 0; }
+    searchKdTreeRadius(tree, point, radius * radius, &set);
+    return set.count;
+}
+
+void queryKdTreeNearestBatch(const KdTree *tree, const simd_float3 *points, int count, int k,
+                             float maxDistance, uint32_t *results, float *distances, int *counts,
+                             JobSystem *system)
+{
+    parallelFor(system, count, POINT_INDEX_QUERY_GRAIN, [=](int begin, int end) {
+        for (int i = begin; i < end; i++) {
+            const size_t offset = (size_t)i * k;
+            const int found = queryKdTreeNearest(tree, points[i], k, maxDistance,
+                                                 results + offset,
+                                                 distances != NULL ? distances + offset : NULL);
+            if (counts != NULL) { counts[i] = found; }
+        }
+    });
+}
+
+void queryKdTreeRadiusBatch(const KdTree *tree, const simd_float3 *points, int count,
+                            float radius, uint32_t *results, float *distances, int capacity,
+                            int *counts, JobSystem *system)
+{
+    parallelFor(system, count, POINT_INDEX_QUERY_GRAIN, [=](int begin, int end) {
+        for (int i = begin; i < end; i++) {
+            const size_t offset = (size_t)i * capacity;
+            const int found = queryKdTreeRadius(tree, points[i], radius, results + offset,
+                                                distances != NULL ? distances + offset : NULL,
+                                                capacity);
+            if (counts != NULL) { counts[i] = found; }
+        }
+    });
+}
+
+// Point grid
+
+struct PointGrid {
+    float cellSize;
+    float inverseCellSize;
+    std::vector<simd_float4> points;    // grouped by bucket
+    std::vector<uint32_t> slots;        // id -> index into points
+    std::vector<uint32_t> bucketStarts; // one past the bucket count
+    uint32_t bucketMask;
+    simd_int3 minCell;
+    simd_int3 maxCell;
+};
+
+static inline simd_int3 getPointGridCell(const PointGrid *grid, simd_float3 point)
+{
+    // kept well inside int so neighbouring cells and ring offsets can't overflow
+    const simd_float3 lower = -536870912.0;
+    const simd_float3 upper = 536870912.0;
+    const simd_float3 cell = simd_floor(point * grid->inverseCellSize);
+    return simd_int(simd_min(simd_max(cell, lower), upper));
+}
+
+static inline uint32_t getPointGridBucket(const PointGrid *grid, simd_int3 cell)
+{
+    uint32_t hash = ((uint32_t)cell.x * 73856093u) ^ ((uint32_t)cell.y * 19349663u) ^
+                    ((uint32_t)cell.z * 83492791u);
+    hash ^= hash >> 16;
+    hash *= 0x85ebca6bu;
+    hash ^= hash >> 13;
+    return hash & grid->bucketMask;
+}
+
+// Calls visit for every point in cell, buckets are shared by every cell that hashes to them
+template <typename Visitor>
+static inline void visitPointGridCell(const PointGrid *grid, simd_int3 cell, Visitor &&visit)
+{
+    const uint32_t bucket = getPointGridBucket(grid, cell);
+    const simd_float4 *points = grid->points.data();
+    for (uint32_t i = grid->bucketStarts[bucket]; i < grid->bucketStarts[bucket + 1]; i++) {
+        const simd_float4 p = points[i];
+        if (simd_any(getPointGridCell(grid, simd_make_float3(p)) != cell)) { continue; }
+        visit(p);
+    }
+}
+
+// Sorts the points by bucket (counting sort) and finds the occupied cell range
+static void binPointGrid(PointGrid *grid, JobSystem *system)
+{
+    const int count = (int)grid->points.size();
+    uint32_t bucketCount = 1;
+    while (bucketCount < (uint32_t)count) {
+        bucketCount <<= 1;
+    }
+    grid->bucketMask = bucketCount - 1;
+
+    std::vector<uint32_t> buckets(count);
+    simd_int3 minCell = INT_MAX;
+    simd_int3 maxCell = INT_MIN;
+    std::mutex mutex;
+    const simd_float4 *points = grid->points.data();
+    parallelFor(system, count, POINT_INDEX_GRAIN, [&](int begin, int end) {
+        simd_int3 lower = INT_MAX;
+        simd_int3 upper = INT_MIN;
+        for (int i = begin; i < end; i++) {
+            const simd_int3 cell = getPointGridCell(grid, simd_make_float3(points[i]));
+            lower = simd_min(lower, cell);
+            upper = simd_max(upper, cell);
+            buckets[i] = getPointGridBucket(grid, cell);
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        minCell = simd_min(minCell, lower);
+        maxCell = simd_max(maxCell, upper);
+    });
+    grid->minCell = minCell;
+    grid->maxCell = maxCell;
+
+    // bucket ends, then walking the points backwards turns them into starts
+    grid->bucketStarts.assign(bucketCount + 1, 0);
+    uint32_t *starts = grid->bucketStarts.data();
+    for (int i = 0; i < count; i++) {
+        starts[buckets[i]]++;
+    }
+    for (uint32_t i = 1; i < bucketCount; i++) {
+        starts[i] += starts[i - 1];
+    }
+    starts[bucketCount] = count;
+
+    std::vector<simd_float4> sorted(count);
+    grid->slots.resize(count);
+    for (int i = count - 1; i >= 0; i--) {
+        const uint32_t slot = --starts[buckets[i]];
+        sorted[slot] = points[i];
+        grid->slots[getIndexedPointId(points[i])] = slot;
+    }
+    grid->points.swap(sorted);
+}
+
+PointGrid *createPointGrid(const void *positions, uint32_t positionStride, int count,
+                           float cellSize, JobSystem *system)
+{
+    ProfileSpan span(__func__);
+    PointGrid *grid = new PointGrid();
+    grid->cellSize = cellSize > 0.0 ? cellSize : 1.0;
+    grid->inverseCellSize = 1.0 / grid->cellSize;
+    copyIndexedPoints(grid->points, positions, positionStride, std::max(count, 0), system);
+    binPointGrid(grid, system);
+    span.setGeometry(getPointGridCount(grid), 0);
+    return grid;
+}
+
+PointGrid *createPointGridFromGeometry(const GeometryData *geometry, float cellSize,
+                                       JobSystem *system)
+{
+    return createPointGrid(geometry->vertexData, sizeof(Vertex), geometry->vertexCount, cellSize,
+                           system);
+}
+
+void freePointGrid(PointGrid *grid) { delete grid; }
+
+int getPointGridCount(const PointGrid *grid) { return (int)grid->points.size(); }
+
+float getPointGridCellSize(const PointGrid *grid) { return grid->cellSize; }
+
+simd_float3 getPointGridPoint(const PointGrid *grid, uint32_t id)
+{
+    return simd_make_float3(grid->points[grid->slots[id]]);
+}
+
+void updatePointGridPoint(PointGrid *grid, uint32_t id, simd_float3 position)
+{
+    updatePointGridPoints(grid, &position, sizeof(simd_float3), &id, 1, NULL);
+}
+
+void updatePointGridPoints(PointGrid *grid, const void *positions, uint32_t positionStride,
+                           const uint32_t *ids, int count, JobSystem *system)
+{
+    const int pointCount = getPointGridCount(grid);
+    if (ids == NULL) { count = pointCount; }
+    if (count <= 0 || pointCount == 0) { return; }
+
+    // points that stay in their cell are updated in place
+    std::atomic<bool> moved(false);
+    simd_float4 *points = grid->points.data();
+    const uint32_t *slots = grid->slots.data();
+    parallelFor(system, count, POINT_INDEX_GRAIN, [&](int begin, int end) {
+        bool changed = false;
+        for (int i = begin; i < end; i++) {
+            const uint32_t id = ids != NULL ? ids[i] : (uint32_t)i;
+            if (id >= (uint32_t)pointCount) { continue; }
+
+            const simd_float3 position = readPosition(positions, positionStride, i);
+            simd_float4 *point = &points[slots[id]];
+            const simd_int3 from = getPointGridCell(grid, simd_make_float3(*point));
+            changed |= simd_any(from != getPointGridCell(grid, position));
+            *point = makeIndexedPoint(position, id);
+        }
+        if (changed) { moved.store(true, std::memory_order_relaxed); }
+    });
+
+    if (moved.load(std::memory_order_relaxed)) { binPointGrid(grid, system); }
+}
+
+int queryPointGridNearest(const PointGrid *grid, simd_float3 point, int k, float maxDistance,
+                          uint32_t *results, float *distances)
+{
+    if (k <= 0 || grid->points.empty()) { return 0; }
+    NearestSet set = makeNearestSet(results, distances, k, maxDistance);
+
+    auto visit = [&set, point](simd_float4 p) {
+        const float distance = simd_distance_squared(simd_make_float3(p), point);
+        insertNearest(&set, getIndexedPointId(p), distance);
+    };
+
+    // search rings of cells outwards, starting with the first ring that reaches the grid
+    const simd_int3 zero = 0;
+    const simd_int3 minCell = grid->minCell;
+    const simd_int3 maxCell = grid->maxCell;
+    const simd_int3 center = getPointGridCell(grid, point);
+    const int firstRing =
+        simd_reduce_max(simd_max(simd_max(minCell - center, center - maxCell), zero));
+    const int lastRing = simd_reduce_max(simd_max(center - minCell, maxCell - center));
+
+    // every point left past ring r is at least r - 1 cells plus the gap to the query's own cell's
+    // nearest side away
+    const simd_float3 local = point - simd_float(center) * grid->cellSize;
+    const float gap = std::max(simd_reduce_min(simd_min(local, grid->cellSize - local)), 0.0f);
+
+    int64_t visited = 0;
+    for (int ring = firstRing; ring <= lastRing; ring++) {
+        const float reach = (float)(ring - 1) * grid->cellSize + gap;
+        if (ring > 0 && reach * reach > set.limit) { break; }
+
+        // sparse grids are cheaper to scan than to walk
+        const int64_t side = 2 * (int64_t)ring + 1;
+        visited += side * side * 6;
+        if (visited > (int64_t)grid->points.size()) {
+            set = makeNearestSet(results, distances, k, maxDistance);
+            for (const simd_float4 &p : grid->points) {
+                visit(p);
+            }
+            break;
+        }
+
+        const int z0 = std::max(-ring, minCell.z - center.z);
+        const int z1 = std::min(ring, maxCell.z - center.z);
+        const int y0 = std::max(-ring, minCell.y - center.y);
+        const int y1 = std::min(ring, maxCell.y - center.y);
+        const int x0 = std::max(-ring, minCell.x - center.x);
+        const int x1 = std::min(ring, maxCell.x - center.x);
+        for (int dz = z0; dz <= z1; dz++) {
+            for (int dy = y0; dy <= y1; dy++) {
+                // between the ring's z & y faces only its two x ends are on the ring
+                const bool face = abs(dz) == ring || abs(dy) == ring;
+                const int step = face ? 1 : 2 * ring;
+                for (int dx = face ? x0 : -ring; dx <= x1; dx += step) {
+                    if (dx < x0) { continue; }
+                    visitPointGridCell(grid, center + simd_make_int3(dx, dy, dz), visit);
+                }
+            }
+        }
+    }
+
+    return finishNearest(&set, distances);
+}
+
+int queryPointGridRadius(const PointGrid *grid, simd_float3 point, float radius,
+                         uint32_t *results, float *distances, int capacity)
+{
+    RadiusSet set = { .ids = results, .distances = distances, .capacity = capacity, .count = 0 };
+    if (radius < 0.0 || grid->points.empty()) { return 0; }
+
+    const float radius2 = radius * radius;
+    auto visit = [&set, point, radius2](simd_float4 p) {
+        const float distance = simd_distance_squared(simd_make_float3(p), point);
+        if (distance <= radius2) { addRadiusResult(&set, getIndexedPointId(p), distance); }
+    };
+
+    const simd_int3 lower = simd_max(getPointGridCell(grid, point - radius), grid->minCell);
+    const simd_int3 upper = simd_min(getPointGridCell(grid, point + radius), grid->maxCell);
+    if (simd_any(lower > upper)) { return 0; }
+
+    // sparse grids are cheaper to scan than to walk
+    const simd_long3 cells = simd_long(upper - lower) + 1;
+    if (cells.x * cells.y * cells.z > (int64_t)grid->points.size()) {
+        for (const simd_float4 &p : grid->points) {
+            visit(p);
+        }
+        return set.count;
+    }
+
+    for (int z = lower.z; z <= upper.z; z++) {
+        for (int y = lower.y; y <= upper.y; y++) {
+            for (int x = lower.x; x <= upper.x; x++) {
+                visitPointGridCell(grid, simd_make_int3(x, y, z), visit);
+            }
+        }
+    }
+    return set.count;
+}
+
+void queryPointGridNearestBatch(const PointGrid *grid, const simd_float3 *points, int count, int k,
+                                float maxDistance, uint32_t *results, float *distances,
+                                int *counts, JobSystem *system)
+{
+    parallelFor(system, count, POINT_INDEX_QUERY_GRAIN, [=](int begin, int end) {
+        for (int i = begin; i < end; i++) {
+            const size_t offset = (size_t)i * k;
+            const int found = queryPointGridNearest(grid, points[i], k, maxDistance,
+                                                    results + offset,
+                                                    distances != NULL ? distances + offset : NULL);
+            if (counts != NULL) { counts[i] = found; }
+        }
+    });
+}
+
+void queryPointGridRadiusBatch(const PointGrid *grid, const simd_float3 *points, int count,
+                               float radius, uint32_t *results, float *distances, int capacity,
+                               int *counts, JobSystem *system)
+{
+    parallelFor(system, count, POINT_INDEX_QUERY_GRAIN, [=](int begin, int end) {
+        for (int i = begin; i < end; i++) {
+            const size_t offset = (size_t)i * capacity;
+            const int found = queryPointGridRadius(grid, points[i], radius, results + offset,
+                                                   distances != NULL ? distances + offset : NULL,
+                                                   capacity);
+            if (counts != NULL) { counts[i] = found; }
+        }
+    });
+}
@@ -0,0 +1,216 @@
+//
+//  Profiler.mm
+//  Satin
+//
+//  Created by agent on 10/19/26.
+//
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <pthread.h>
+#include <stdio.h>
+#include <time.h>
+
+#include "Profiler.h"
+
+typedef struct {
+    const char *name;
+    uint64_t start;
+    uint64_t end;
+    uint64_t threadID;
+    int vertexCount;
+    int triangleCount;
+    bool hasGeometry;
+} ProfileSpanEvent;
+
+static std::atomic<bool> profilingEnabled(false);
+static std::atomic<uint64_t> profileCounters[ProfileCounterCount];
+
+static std::mutex profileSpansMutex;
+static std::vector<ProfileSpanEvent> profileSpans;
+// long captures stop recording instead of growing without bound, drops are counted
+static size_t profileSpanCapacity = 1 << 18;
+static uint64_t profileSpansDropped = 0;
+
+static const char *profileCounterNames[ProfileCounterCount] = {
+    "triangulatorEarTests",  "triangulatorDiagonalEdgeChecks",
+    "triangulatorHoleBridges", "triangulatorFailures",
+    "bvhNodesBuilt",         "bvhSAHEvaluations",
+    "bvhRays",               "bvhNodesVisited",
+    "bvhTrianglesTested",    "generatorCalls",
+    "generatedVertices",     "generatedTriangles",
+    "meshletsBuilt",         "meshletsCulled"
+};
+
+static uint64_t profileTimestamp(void)
+{
+    // never 0 so a 0 start can mean "profiling was disabled when the span began"
+    return clock_gettime_nsec_np(CLOCK_UPTIME_RAW) | 1;
+}
+
+static uint64_t profileThreadID(void)
+{
+    uint64_t tid = 0;
+    pthread_threadid_np(NULL, &tid);
+    return tid;
+}
+
+void setProfilingEnabled(bool enabled) { profilingEnabled.store(enabled, std::memory_order_relaxed); }
+
+bool isProfilingEnabled(void) { return profilingEnabled.load(std::memory_order_relaxed); }
+
+void addProfileCounter(ProfileCounter counter, uint64_t value)
+{
+    if (!isProfilingEnabled() || counter < 0 || counter >= ProfileCounterCount) { return; }
+    profileCounters[counter].fetch_add(value, std::memory_order_relaxed);
+}
+
+uint64_t getProfileCounter(ProfileCounter counter)
+{
+    if (counter < 0 || counter >= ProfileCounterCount) { return 0; }
+    return profileCounters[counter].load(std::memory_order_relaxed);
+}
+
+const char *getProfileCounterName(ProfileCounter counter)
+{
+    if (counter < 0 || counter >= ProfileCounterCount) { return ""; }
+    return profileCounterNames[counter];
+}
+
+void resetProfileCounters(void)
+{
+    for (int i = 0; i < ProfileCounterCount; i++) {
+        profileCounters[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+void addBVHRayProfile(uint64_t nodesVisited, uint64_t trianglesTested)
+{
+    if (!isProfilingEnabled()) { return; }
+    profileCounters[ProfileCounterBVHRays].fetch_add(1, std::memory_order_relaxed);
+    profileCounters[ProfileCounterBVHNodesVisited].fetch_add(nodesVisited,
+                                                             std::memory_order_relaxed);
+    profileCounters[ProfileCounterBVHTrianglesTested].fetch_add(trianglesTested,
+                                                                std::memory_order_relaxed);
+}
+
+static thread_local int generatorProfileDepth = 0;
+
+int enterGeneratorProfile(void) { return ++generatorProfileDepth; }
+
+void exitGeneratorProfile(void) { generatorProfileDepth--; }
+
+uint64_t beginProfileSpan(void) { return isProfilingEnabled() ? profileTimestamp() : 0; }
+
+static void recordProfileSpan(const char *name, uint64_t start, int vertexCount,
+                              int triangleCount, bool hasGeometry)
+{
+    if (start == 0 || name == NULL || !isProfilingEnabled()) { return; }
+    const ProfileSpanEvent event = { .name = name,
+                                     .start = start,
+                                     .end = profileTimestamp(),
+                                     .threadID = profileThreadID(),
+                                     .vertexCount = vertexCount,
+                                     .triangleCount = triangleCount,
+                                     .hasGeometry = hasGeometry };
+
+    std::lock_guard<std::mutex> lock(profileSpansMutex);
+    if (profileSpans.size() >= profileSpanCapacity) {
+        profileSpansDropped++;
+        return;
+    }
+    profileSpans.push_back(event);
+}
+
+void endProfileSpan(const char *name, uint64_t start)
+{
+    recordProfileSpan(name, start, 0, 0, false);
+}
+
+void endProfileSpanWithGeometry(const char *name, uint64_t start, int vertexCount,
+                                int triangleCount)
+{
+    recordProfileSpan(name, start, vertexCount, triangleCount, true);
+}
+
+int getProfileSpanCount(void)
+{
+    std::lock_guard<std::mutex> lock(profileSpansMutex);
+    return (int)profileSpans.size();
+}
+
+uint64_t getDroppedProfileSpanCount(void)
+{
+    std::lock_guard<std::mutex> lock(profileSpansMutex);
+    return profileSpansDropped;
+}
+
+void setProfileSpanCapacity(int capacity)
+{
+    std::lock_guard<std::mutex> lock(profileSpansMutex);
+    profileSpanCapacity = capacity > 0 ? (size_t)capacity : 0;
+    if (profileSpans.size() > profileSpanCapacity) {
+        profileSpansDropped += profileSpans.size() - profileSpanCapacity;
+        profileSpans.resize(profileSpanCapacity);
+    }
+}
+
+void clearProfileSpans(void)
+{
+    std::lock_guard<std::mutex> lock(profileSpansMutex);
+    profileSpans.clear();
+    profileSpansDropped = 0;
+}
+
+bool writeProfileTrace(const char *path)
+{
+    FILE *file = fopen(path, "w");
+    if (file == NULL) { return false; }
+
+    std::vector<ProfileSpanEvent> spans;
+    uint64_t dropped = 0;
+    {
+        std::lock_guard<std::mutex> lock(profileSpansMutex);
+        spans = profileSpans;
+        dropped = profileSpansDropped;
+    }
+
+    uint64_t origin = UINT64_MAX;
+    for (const ProfileSpanEvent &span : spans) {
+        if (span.start < origin) { origin = span.start; }
+    }
+    if (spans.empty()) { origin = 0; }
+
+    fprintf(file, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+
+    // trace timestamps are in microseconds
+    uint64_t last = 0;
+    for (size_t i = 0; i < spans.size(); i++) {
+        const ProfileSpanEvent &span = spans[i];
+        fprintf(file,
+                "{\"name\":\"%s\",\"cat\":\"SatinCore\",\"ph\":\"X\",\"pid\":1,\"tid\":%llu,"
+                "\"ts\":%.3f,\"dur\":%.3f",
+                span.name, (unsigned long long)span.threadID, (span.start - origin) / 1000.0,
+                (span.end - span.start) / 1000.0);
+        if (span.hasGeometry) {
+            fprintf(file, ",\"args\":{\"vertexCount\":%d,\"triangleCount\":%d}",
+                    span.vertexCount, span.triangleCount);
+        }
+        fprintf(file, "},\n");
+        if (span.end - origin > last) { last = span.end - origin; }
+    }
+
+    fprintf(file, "{\"name\":\"SatinCore Counters\",\"ph\":\"C\",\"pid\":1,\"ts\":%.3f,\"args\":{",
+            last / 1000.0);
+    for (int i = 0; i < ProfileCounterCount; i++) {
+        fprintf(file, "%s\"%s\":%llu", i > 0 ? "," : "", profileCounterNames[i],
+                (unsigned long long)getProfileCounter((ProfileCounter)i));
+    }
+    fprintf(file, ",\"droppedSpans\":%llu}}\n],\"otherData\":{\"droppedSpans\":%llu}}\n",
+            (unsigned long long)dropped, (unsigned long long)dropped);
+
+    const bool success = ferror(file) == 0;
+    fclose(file);
+    return success;
+}
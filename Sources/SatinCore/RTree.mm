@@ -0,0 +1,576 @@
+//
+//  RTree.mm
+//  Satin
+//
+//  Created by agent on 10/19/26.
+//
+
+#include <algorithm>
+#include <math.h>
+#include <queue>
+#include <unordered_map>
+#include <vector>
+
+#include "RTree.h"
+#include "Rectangle.h"
+
+// Nodes & entries live in pools addressed by index, freed slots are recycled through free lists
+
+#define RTREE_MAX_CHILDREN 16
+#define RTREE_MIN_CHILDREN 6
+// Traversal stack kept on the call stack, covers height * (RTREE_MAX_CHILDREN - 1) + 1 nodes for
+// any reasonably balanced tree, deeper ones spill onto the heap
+#define RTREE_STACK_SIZE 256
+
+typedef struct {
+    Rectangle rect;
+    int parent;
+    int count;
+    bool leaf;
+    // leaves store entry indices, internal nodes store node indices
+    int children[RTREE_MAX_CHILDREN];
+} RTreeNode;
+
+typedef struct {
+    Rectangle rect;
+    uint32_t id;
+    int node;
+} RTreeEntry;
+
+struct RTree {
+    std::vector<RTreeNode> nodes;
+    std::vector<RTreeEntry> entries;
+    std::vector<int> freeNodes;
+    std::vector<int> freeEntries;
+    std::unordered_map<uint32_t, int> entryMap;
+    int root;
+};
+
+/* Rectangle Helpers */
+
+static float rectangleArea(const Rectangle &rect)
+{
+    if (rect.min.x > rect.max.x || rect.min.y > rect.max.y) { return 0.0; }
+    const simd_float2 size = rect.max - rect.min;
+    return size.x * size.y;
+}
+
+static float rectangleEnlargement(const Rectangle &rect, const Rectangle &add)
+{
+    Rectangle merged = rect;
+    mergeRectangleInPlace(&merged, &add);
+    return rectangleArea(merged) - rectangleArea(rect);
+}
+
+static float rectangleOverlap(const Rectangle &a, const Rectangle &b)
+{
+    const Rectangle overlap = (Rectangle) { .min = simd_max(a.min, b.min),
+                                            .max = simd_min(a.max, b.max) };
+    return rectangleArea(overlap);
+}
+
+static float rectanglePointDistanceSquared(const Rectangle &rect, simd_float2 pt)
+{
+    const simd_float2 d =
+        simd_max(simd_max(rect.min - pt, pt - rect.max), simd_make_float2(0.0, 0.0));
+    return simd_length_squared(d);
+}
+
+static simd_float2 rectangleCenter(const Rectangle &rect) { return (rect.min + rect.max) * 0.5; }
+
+/* Pool Helpers */
+
+static int allocateRTreeNode(RTree *tree, bool leaf)
+{
+    int index;
+    if (!tree->freeNodes.empty()) {
+        index = tree->freeNodes.back();
+        tree->freeNodes.pop_back();
+    }
+    else {
+        index = (int)tree->nodes.size();
+        tree->nodes.emplace_back();
+    }
+    RTreeNode &node = tree->nodes[index];
+    node.rect = createRectangle();
+    node.parent = -1;
+    node.count = 0;
+    node.leaf = leaf;
+    return index;
+}
+
+static void freeRTreeNode(RTree *tree, int index) { tree->freeNodes.push_back(index); }
+
+static int allocateRTreeEntry(RTree *tree, uint32_t id, Rectangle rect)
+{
+    int index;
+    if (!tree->freeEntries.empty()) {
+        index = tree->freeEntries.back();
+        tree->freeEntries.pop_back();
+    }
+    else {
+        index = (int)tree->entries.size();
+        tree->entries.emplace_back();
+    }
+    tree->entries[index] = (RTreeEntry) { .rect = rect, .id = id, .node = -1 };
+    tree->entryMap[id] = index;
+    return index;
+}
+
+static const Rectangle &rtreeChildRectangle(const RTree *tree, const RTreeNode &node, int i)
+{
+    return node.leaf ? tree->entries[node.children[i]].rect : tree->nodes[node.children[i]].rect;
+}
+
+static void setRTreeChild(RTree *tree, int nodeIndex, int slot, int child)
+{
+    RTreeNode &node = tree->nodes[nodeIndex];
+    node.children[slot] = child;
+    if (node.leaf) { tree->entries[child].node = nodeIndex; }
+    else {
+        tree->nodes[child].parent = nodeIndex;
+    }
+}
+
+static void refitRTreeNode(RTree *tree, int nodeIndex)
+{
+    RTreeNode &node = tree->nodes[nodeIndex];
+    node.rect = createRectangle();
+    for (int i = 0; i < node.count; i++) {
+        mergeRectangleInPlace(&node.rect, &rtreeChildRectangle(tree, node, i));
+    }
+}
+
+static void refitRTreeAncestors(RTree *tree, int nodeIndex)
+{
+    while (nodeIndex != -1) {
+        refitRTreeNode(tree, nodeIndex);
+        nodeIndex = tree->nodes[nodeIndex].parent;
+    }
+}
+
+/* Bulk Loading */
+
+// Packs items (entry or node indices) into parents of RTREE_MAX_CHILDREN using Sort-Tile-Recursive
+static std::vector<int> packRTreeLevel(RTree *tree, std::vector<int> &items, bool leaf)
+{
+    auto rect = [&](int item) -> const Rectangle & {
+        return leaf ? tree->entries[item].rect : tree->nodes[item].rect;
+    };
+
+    const int count = (int)items.size();
+    const int parentCount = (count + RTREE_MAX_CHILDREN - 1) / RTREE_MAX_CHILDREN;
+    const int sliceCount = (int)ceilf(sqrtf((float)parentCount));
+    const int sliceSize = sliceCount * RTREE_MAX_CHILDREN;
+
+    std::sort(items.begin(), items.end(), [&](int a, int b) {
+        return rectangleCenter(rect(a)).x < rectangleCenter(rect(b)).x;
+    });
+
+    std::vector<int> parents;
+    parents.reserve(parentCount);
+    for (int start = 0; start < count; start += sliceSize) {
+        const int end = std::min(start + sliceSize, count);
+        std::sort(items.begin() + start, items.begin() + end, [&](int a, int b) {
+            return rectangleCenter(rect(a)).y < rectangleCenter(rect(b)).y;
+        });
+
+        for (int i = start; i < end; i += RTREE_MAX_CHILDREN) {
+            const int nodeIndex = allocateRTreeNode(tree, leaf);
+            const int n = std::min(RTREE_MAX_CHILDREN, end - i);
+            for (int j = 0; j < n; j++) {
+                setRTreeChild(tree, nodeIndex, j, items[i + j]);
+            }
+            tree->nodes[nodeIndex].count = n;
+            refitRTreeNode(tree, nodeIndex);
+            parents.push_back(nodeIndex);
+        }
+    }
+    return parents;
+}
+
+RTree *createRTree(const Rectangle *rects, const uint32_t *ids, int count)
+{
+    RTree *tree = new RTree();
+    tree->entries.reserve(count);
+    tree->nodes.reserve(count / (RTREE_MAX_CHILDREN / 2) + 1);
+
+    std::vector<int> items;
+    items.reserve(count);
+    for (int i = 0; i < count; i++) {
+        const uint32_t id = ids != NULL ? ids[i] : (uint32_t)i;
+        auto existing = tree->entryMap.find(id);
+        if (existing != tree->entryMap.end()) {
+            tree->entries[existing->second].rect = rects[i];
+            continue;
+        }
+        items.push_back(allocateRTreeEntry(tree, id, rects[i]));
+    }
+
+    if (items.empty()) {
+        tree->root = allocateRTreeNode(tree, true);
+        return tree;
+    }
+
+    bool leaf = true;
+    do {
+        items = packRTreeLevel(tree, items, leaf);
+        leaf = false;
+    } while (items.size() > 1);
+
+    tree->root = items[0];
+    return tree;
+}
+
+void freeRTree(RTree *tree) { delete tree; }
+
+int getRTreeCount(const RTree *tree) { return (int)tree->entryMap.size(); }
+
+Rectangle getRTreeBounds(const RTree *tree) { return tree->nodes[tree->root].rect; }
+
+/* Insertion */
+
+static int chooseRTreeLeaf(RTree *tree, const Rectangle &rect)
+{
+    int nodeIndex = tree->root;
+    while (!tree->nodes[nodeIndex].leaf) {
+        const RTreeNode &node = tree->nodes[nodeIndex];
+        int best = node.children[0];
+        float bestEnlargement = INFINITY;
+        float bestArea = INFINITY;
+        for (int i = 0; i < node.count; i++) {
+            const Rectangle &childRect = tree->nodes[node.children[i]].rect;
+            const float enlargement = rectangleEnlargement(childRect, rect);
+            const float area = rectangleArea(childRect);
+            if (enlargement < bestEnlargement ||
+                (enlargement == bestEnlargement && area < bestArea)) {
+                best = node.children[i];
+                bestEnlargement = enlargement;
+                bestArea = area;
+            }
+        }
+        nodeIndex = best;
+    }
+    return nodeIndex;
+}
+
+// Splits an overflowing set of children along the axis & position with the least area + overlap
+static void splitRTreeNode(RTree *tree, int nodeIndex, int extra)
+{
+    const int total = RTREE_MAX_CHILDREN + 1;
+    int children[total];
+    const RTreeNode &node = tree->nodes[nodeIndex];
+    const bool leaf = node.leaf;
+    for (int i = 0; i < RTREE_MAX_CHILDREN; i++) {
+        children[i] = node.children[i];
+    }
+    children[RTREE_MAX_CHILDREN] = extra;
+
+    auto rect = [&](int item) -> const Rectangle & {
+        return leaf ? tree->entries[item].rect : tree->nodes[item].rect;
+    };
+
+    float bestCost = INFINITY;
+    int bestAxis = 0;
+    int bestSplit = RTREE_MIN_CHILDREN;
+    for (int axis = 0; axis < 2; axis++) {
+        std::sort(children, children + total, [&](int a, int b) {
+            return rectangleCenter(rect(a))[axis] < rectangleCenter(rect(b))[axis];
+        });
+
+        Rectangle prefix[total];
+        Rectangle suffix[total];
+        Rectangle running = createRectangle();
+        for (int i = 0; i < total; i++) {
+            mergeRectangleInPlace(&running, &rect(children[i]));
+            prefix[i] = running;
+        }
+        running = createRectangle();
+        for (int i = total - 1; i >= 0; i--) {
+            mergeRectangleInPlace(&running, &rect(children[i]));
+            suffix[i] = running;
+        }
+
+        for (int split = RTREE_MIN_CHILDREN; split <= total - RTREE_MIN_CHILDREN; split++) {
+            const Rectangle &left = prefix[split - 1];
+            const Rectangle &right = suffix[split];
+            const float cost =
+                rectangleArea(left) + rectangleArea(right) + rectangleOverlap(left, right);
+            if (cost < bestCost) {
+                bestCost = cost;
+                bestAxis = axis;
+                bestSplit = split;
+            }
+        }
+    }
+
+    std::sort(children, children + total, [&](int a, int b) {
+        return rectangleCenter(rect(a))[bestAxis] < rectangleCenter(rect(b))[bestAxis];
+    });
+
+    const int siblingIndex = allocateRTreeNode(tree, leaf);
+    for (int i = 0; i < bestSplit; i++) {
+        setRTreeChild(tree, nodeIndex, i, children[i]);
+    }
+    tree->nodes[nodeIndex].count = bestSplit;
+    for (int i = bestSplit; i < total; i++) {
+        setRTreeChild(tree, siblingIndex, i - bestSplit, children[i]);
+    }
+    tree->nodes[siblingIndex].count = total - bestSplit;
+
+    refitRTreeNode(tree, nodeIndex);
+    refitRTreeNode(tree, siblingIndex);
+
+    const int parentIndex = tree->nodes[nodeIndex].parent;
+    if (parentIndex == -1) {
+        const int rootIndex = allocateRTreeNode(tree, false);
+        setRTreeChild(tree, rootIndex, 0, nodeIndex);
+        setRTreeChild(tree, rootIndex, 1, siblingIndex);
+        tree->nodes[rootIndex].count = 2;
+        refitRTreeNode(tree, rootIndex);
+        tree->root = rootIndex;
+        return;
+    }
+
+    RTreeNode &parent = tree->nodes[parentIndex];
+    if (parent.count < RTREE_MAX_CHILDREN) {
+        setRTreeChild(tree, parentIndex, parent.count++, siblingIndex);
+        refitRTreeAncestors(tree, parentIndex);
+    }
+    else {
+        splitRTreeNode(tree, parentIndex, siblingIndex);
+    }
+}
+
+static void insertRTreeEntry(RTree *tree, int entryIndex)
+{
+    const int leafIndex = chooseRTreeLeaf(tree, tree->entries[entryIndex].rect);
+    RTreeNode &leaf = tree->nodes[leafIndex];
+    if (leaf.count < RTREE_MAX_CHILDREN) {
+        setRTreeChild(tree, leafIndex, leaf.count++, entryIndex);
+        refitRTreeAncestors(tree, leafIndex);
+    }
+    else {
+        splitRTreeNode(tree, leafIndex, entryIndex);
+    }
+}
+
+void insertRTree(RTree *tree, uint32_t id, Rectangle rect)
+{
+    if (tree->entryMap.count(id) > 0) {
+        updateRTree(tree, id, rect);
+        return;
+    }
+    insertRTreeEntry(tree, allocateRTreeEntry(tree, id, rect));
+}
+
+/* Removal */
+
+static void collectRTreeEntries(RTree *tree, int nodeIndex, std::vector<int> &entries)
+{
+    const RTreeNode &node = tree->nodes[nodeIndex];
+    for (int i = 0; i < node.count; i++) {
+        if (node.leaf) { entries.push_back(node.children[i]); }
+        else {
+            collectRTreeEntries(tree, node.children[i], entries);
+        }
+    }
+    freeRTreeNode(tree, nodeIndex);
+}
+
+static void removeRTreeChild(RTree *tree, int nodeIndex, int child)
+{
+    RTreeNode &node = tree->nodes[nodeIndex];
+    for (int i = 0; i < node.count; i++) {
+        if (node.children[i] == child) {
+            node.children[i] = node.children[--node.count];
+            return;
+        }
+    }
+}
+
+// Underfull nodes are removed and their entries reinserted so the tree stays balanced
+static void condenseRTree(RTree *tree, int nodeIndex)
+{
+    std::vector<int> orphans;
+    while (nodeIndex != tree->root) {
+        const int parentIndex = tree->nodes[nodeIndex].parent;
+        if (tree->nodes[nodeIndex].count < RTREE_MIN_CHILDREN) {
+            removeRTreeChild(tree, parentIndex, nodeIndex);
+            collectRTreeEntries(tree, nodeIndex, orphans);
+        }
+        else {
+            refitRTreeNode(tree, nodeIndex);
+        }
+        nodeIndex = parentIndex;
+    }
+    refitRTreeNode(tree, tree->root);
+
+    while (!tree->nodes[tree->root].leaf && tree->nodes[tree->root].count == 1) {
+        const int oldRoot = tree->root;
+        tree->root = tree->nodes[oldRoot].children[0];
+        tree->nodes[tree->root].parent = -1;
+        freeRTreeNode(tree, oldRoot);
+    }
+
+    if (!tree->nodes[tree->root].leaf && tree->nodes[tree->root].count == 0) {
+        freeRTreeNode(tree, tree->root);
+        tree->root = allocateRTreeNode(tree, true);
+    }
+
+    for (int entryIndex : orphans) {
+        insertRTreeEntry(tree, entryIndex);
+    }
+}
+
+bool removeRTree(RTree *tree, uint32_t id)
+{
+    auto it = tree->entryMap.find(id);
+    if (it == tree->entryMap.end()) { return false; }
+
+    const int entryIndex = it->second;
+    const int leafIndex = tree->entries[entryIndex].node;
+    tree->entryMap.erase(it);
+    tree->freeEntries.push_back(entryIndex);
+
+    removeRTreeChild(tree, leafIndex, entryIndex);
+    condenseRTree(tree, leafIndex);
+    return true;
+}
+
+bool updateRTree(RTree *tree, uint32_t id, Rectangle rect)
+{
+    auto it = tree->entryMap.find(id);
+    if (it == tree->entryMap.end()) { return false; }
+
+    const int entryIndex = it->second;
+    RTreeEntry &entry = tree->entries[entryIndex];
+    const int leafIndex = entry.node;
+
+    // Small moves that stay inside the leaf only need a refit of the leaf
+    if (rectangleContainsRectangle(tree->nodes[leafIndex].rect, rect)) {
+        entry.rect = rect;
+        refitRTreeAncestors(tree, leafIndex);
+        return true;
+    }
+
+    removeRTreeChild(tree, leafIndex, entryIndex);
+    condenseRTree(tree, leafIndex);
+    tree->entries[entryIndex].rect = rect;
+    insertRTreeEntry(tree, entryIndex);
+    return true;
+}
+
+/* Queries */
+
+typedef struct RTreeStack {
+    int local[RTREE_STACK_SIZE];
+    std::vector<int> heap;
+    int *data = local;
+    int size = 0;
+    int capacity = RTREE_STACK_SIZE;
+
+    void push(int index)
+    {
+        if (size == capacity) {
+            if (data == local) { heap.assign(local, local + size); }
+            capacity *= 2;
+            heap.resize(capacity);
+            data = heap.data();
+        }
+        data[size++] = index;
+    }
+
+    int pop() { return data[--size]; }
+} RTreeStack;
+
+int queryRTreePoint(const RTree *tree, simd_float2 pt, uint32_t *results, int capacity)
+{
+    int found = 0;
+    RTreeStack stack;
+    stack.push(tree->root);
+    while (stack.size > 0) {
+        const RTreeNode &node = tree->nodes[stack.pop()];
+        if (!rectangleContainsPoint(node.rect, pt)) { continue; }
+        for (int i = 0; i < node.count; i++) {
+            if (node.leaf) {
+                const RTreeEntry &entry = tree->entries[node.children[i]];
+                if (rectangleContainsPoint(entry.rect, pt)) {
+                    if (found < capacity) { results[found] = entry.id; }
+                    found++;
+                }
+            }
+            else {
+                stack.push(node.children[i]);
+            }
+        }
+    }
+    return found;
+}
+
+int queryRTreeRectangle(const RTree *tree, Rectangle rect, uint32_t *results, int capacity)
+{
+    int found = 0;
+    RTreeStack stack;
+    stack.push(tree->root);
+    while (stack.size > 0) {
+        const RTreeNode &node = tree->nodes[stack.pop()];
+        if (node.count == 0 || !rectangleIntersectsRectangle(node.rect, rect)) { continue; }
+        for (int i = 0; i < node.count; i++) {
+            if (node.leaf) {
+                const RTreeEntry &entry = tree->entries[node.children[i]];
+                if (rectangleIntersectsRectangle(entry.rect, rect)) {
+                    if (found < capacity) { results[found] = entry.id; }
+                    found++;
+                }
+            }
+            else {
+                stack.push(node.children[i]);
+            }
+        }
+    }
+    return found;
+}
+
+typedef struct {
+    float distance;
+    int index;
+    bool entry;
+} RTreeCandidate;
+
+int queryRTreeNearest(const RTree *tree, simd_float2 pt, int k, uint32_t *results,
+                      float *distances)
+{
+    if (k <= 0) { return 0; }
+
+    // Best first search, entries are only returned once nothing closer is left in the queue
+    auto further = [](const RTreeCandidate &a, const RTreeCandidate &b) {
+        return a.distance > b.distance;
+    };
+    std::priority_queue<RTreeCandidate, std::vector<RTreeCandidate>, decltype(further)> queue(
+        further);
+    queue.push((RTreeCandidate) { .distance = 0.0, .index = tree->root, .entry = false });
+
+    int found = 0;
+    while (!queue.empty() && found < k) {
+        const RTreeCandidate candidate = queue.top();
+        queue.pop();
+
+        if (candidate.entry) {
+            results[found] = tree->entries[candidate.index].id;
+            if (distances != NULL) { distances[found] = sqrtf(candidate.distance); }
+            found++;
+            continue;
+        }
+
+        const RTreeNode &node = tree->nodes[candidate.index];
+        for (int i = 0; i < node.count; i++) {
+            const int child = node.children[i];
+            const Rectangle &rect = rtreeChildRectangle(tree, node, i);
+            queue.push((RTreeCandidate) { .distance = rectanglePointDistanceSquared(rect, pt),
+                                          .index = child,
+                                          .entry = node.leaf });
+        }
+    }
+    return found;
+}
@@ -14,6 +14,7 @@
 
 #include "Triangulator.h"
 #include "Geometry.h"
+#include "Profiler.h"
 
 // #define DEBUGDIAGONAL
 // #define DEBUGTRIANGULATION
@@ -51,6 +52,20 @@ typedef struct {
     TriangleIndices *indexData;
 } TriangulationData;
 
+/* Profiling */
+
+// Hot path counts are kept per thread and flushed once per triangulation
+static thread_local uint64_t earTestCount = 0;
+static thread_local uint64_t diagonalEdgeCheckCount = 0;
+
+static void flushTriangulatorProfileCounters(void)
+{
+    addProfileCounter(ProfileCounterTriangulatorEarTests, earTestCount);
+    addProfileCounter(ProfileCounterTriangulatorDiagonalEdgeChecks, diagonalEdgeCheckCount);
+    earTestCount = 0;
+    diagonalEdgeCheckCount = 0;
+}
+
 /* Helper Functions */
 
 bool _isDiagonalie(tsVertex *vertices, tsVertex *a, tsVertex *b)
@@ -58,6 +73,7 @@ bool _isDiagonalie(tsVertex *vertices, tsVertex *a, tsVertex *b)
     tsVertex *c, *c1;
     c = vertices;
     do {
+        diagonalEdgeCheckCount++;
         c1 = c->next;
         if ((c != a) && (c1 != a) && (c != b) && (c1 != b)) {
             if (isBetween(a->v, b->v, c->v) && isBetween(a->v, b->v, c1->v)) { return false; }
@@ -81,6 +97,7 @@ bool _inCone(tsVertex *a, tsVertex *b)
 
 bool _isDiagonal(tsVertex *vertices, tsVertex *a, tsVertex *b)
 {
+    earTestCount++;
     const bool i0 = _inCone(a, b);
     const bool i1 = _inCone(b, a);
     const bool i2 = _isDiagonalie(vertices, a, b);
@@ -119,7 +136,7 @@ tsVertex *createVertexStructureFromPath(simd_float2 *path, int length, int index
     tsVertex *vertices = (tsVertex *)malloc(sizeof(tsVertex) * length);
 
     if (data->vertexCount == 0) {
-        data->vertexData = (Vertex *)malloc(sizeof(Vertex) * length);
+        data->vertexData = allocateVertexData(length);
         data->vertexCount = length;
     }
     else {
@@ -450,6 +467,7 @@ bool combineOuterAndInnerPaths(tsPath *outerPath, tsPath *innerPath, tsVertex *p
         outerPath->added += 2;
 
         innerPath->parent = outerPath;
+        addProfileCounter(ProfileCounterTriangulatorHoleBridges, 1);
         return true;
     }
 
@@ -523,6 +541,7 @@ int _triangulate(tsVertex *vertices, int count, int added, TriangulationData *da
 {
     if (initalizeEars(vertices) == 0) {
         printf("Invalid Polygon: Doesn't have any ears.\n");
+        addProfileCounter(ProfileCounterTriangulatorFailures, 1);
         return 1;
     }
 
@@ -538,7 +557,7 @@ int _triangulate(tsVertex *vertices, int count, int added, TriangulationData *da
 
     int triangleIndex = 0;
     data->indexCount = count + added - 2;
-    data->indexData = (TriangleIndices *)malloc(sizeof(TriangleIndices) * data->indexCount);
+    data->indexData = allocateIndexData(data->indexCount);
 
     tsVertex *v0, *v1, *v2 = vertices, *v3, *v4;
     int n = count + added;
@@ -581,6 +600,7 @@ int _triangulate(tsVertex *vertices, int count, int added, TriangulationData *da
             } while (head != vertices);
             printf("\n");
 #endif
+            addProfileCounter(ProfileCounterTriangulatorFailures, 1);
             return 2;
         }
 #endif
@@ -863,6 +883,7 @@ int extrudePaths(simd_float2 **paths, int *lengths, int count, GeometryData *gDa
 
 int triangulate(simd_float2 **paths, int *lengths, int count, GeometryData *gData)
 {
+    ProfileSpan span("triangulate");
     int success = 0;
     GeometryData geometryData =
         (GeometryData) { .vertexCount = 0, .vertexData = NULL, .indexCount = 0, .indexData = NULL };
@@ -945,11 +966,15 @@ int triangulate(simd_float2 **paths, int *lengths, int count, GeometryData *gDat
 
     if (poolLength > 0) { free(pool); }
 
+    flushTriangulatorProfileCounters();
+    span.setGeometry(gData->vertexCount, gData->indexCount);
     return success;
 }
 int triangulateMesh(Vertex *vertices, int vertexCount, const uint32_t **faces, int *faceLengths,
                     int faceCount, GeometryData *gData, TriangleFaceMap *triangleFaceMap)
 {
+    ProfileSpan span("triangulateMesh");
+
     // Copy Vertex Data
     GeometryData rData = (GeometryData) {
         .vertexCount = vertexCount, .vertexData = vertices, .indexCount = 0, .indexData = NULL
@@ -1022,6 +1047,9 @@ int triangulateMesh(Vertex *vertices, int vertexCount, const uint32_t **faces, i
     }
     free(structures);
 
+    flushTriangulatorProfileCounters();
+    span.setGeometry(gData->vertexCount, gData->indexCount);
+
     // Return if all the triangulations were successful
     return success;
 }
@@ -6,7 +6,9 @@
 //
 
 #include <malloc/_malloc.h>
+#include <malloc/malloc.h>
 #include <string.h>
+#include <unistd.h>
 
 #include "Geometry.h"
 #include "Types.h"
@@ -27,21 +29,114 @@ GeometryData createGeometryData()
         GeometryData) { .vertexCount = 0, .vertexData = NULL, .indexCount = 0, .indexData = NULL };
 }
 
+GeometryData createGeometryDataWithStorage(Vertex *vertexData, int vertexCount,
+                                           TriangleIndices *indexData, int indexCount,
+                                           GeometryDataDeleter deleter, void *deleterContext)
+{
+    const GeometryDataOwnership ownership =
+        deleter != NULL ? GeometryDataCustom : GeometryDataBorrowed;
+    return (GeometryData) { .vertexCount = vertexCount,
+                            .vertexData = vertexData,
+                            .indexCount = indexCount,
+                            .indexData = indexData,
+                            .ownership = ownership,
+                            .deleter = deleter,
+                            .deleterContext = deleterContext };
+}
+
 void freeGeometryData(GeometryData *data)
 {
-    if (data->vertexCount > 0 && data->vertexData != NULL) {
-        free(data->vertexData);
+    if (data->ownership == GeometryDataCustom) {
+        if (data->vertexData != NULL) { data->deleter(data->vertexData, data->deleterContext); }
+        if (data->indexData != NULL) { data->deleter(data->indexData, data->deleterContext); }
+        data->vertexData = NULL;
+        data->indexData = NULL;
         data->vertexCount = 0;
+        data->indexCount = 0;
     }
-
-    if (data->indexCount > 0 && data->indexData != NULL) {
-        free(data->indexData);
+    else if (data->ownership == GeometryDataBorrowed) {
+        data->vertexData = NULL;
+        data->indexData = NULL;
+        data->vertexCount = 0;
         data->indexCount = 0;
     }
+    else {
+        if (data->vertexCount > 0 && data->vertexData != NULL) {
+            free(data->vertexData);
+            data->vertexData = NULL;
+            data->vertexCount = 0;
+        }
+
+        if (data->indexCount > 0 && data->indexData != NULL) {
+            free(data->indexData);
+            data->indexData = NULL;
+            data->indexCount = 0;
+        }
+    }
+
+    data->ownership = GeometryDataOwned;
+    data->deleter = NULL;
+    data->deleterContext = NULL;
+}
+
+void makeGeometryDataResizable(GeometryData *data)
+{
+    if (data->ownership == GeometryDataOwned) { return; }
+
+    Vertex *vertexData = NULL;
+    TriangleIndices *indexData = NULL;
+    const int vertexCount = data->vertexCount;
+    const int indexCount = data->indexCount;
+    if (vertexCount > 0 && data->vertexData != NULL) {
+        vertexData = (Vertex *)malloc(vertexCount * sizeof(Vertex));
+        memcpy(vertexData, data->vertexData, vertexCount * sizeof(Vertex));
+    }
+    if (indexCount > 0 && data->indexData != NULL) {
+        indexData = (TriangleIndices *)malloc(indexCount * sizeof(TriangleIndices));
+        memcpy(indexData, data->indexData, indexCount * sizeof(TriangleIndices));
+    }
+
+    freeGeometryData(data);
+    data->vertexCount = vertexData != NULL ? vertexCount : 0;
+    data->vertexData = vertexData;
+    data->indexCount = indexData != NULL ? indexCount : 0;
+    data->indexData = indexData;
+}
+
+static void *allocatePageAligned(size_t length)
+{
+    const size_t pageSize = getpagesize();
+    if (length < pageSize) { return malloc(length); }
+
+    void *data = NULL;
+    const size_t alignedLength = (length + pageSize - 1) & ~(pageSize - 1);
+    if (posix_memalign(&data, pageSize, alignedLength) != 0) { return NULL; }
+    return data;
+}
+
+Vertex *allocateVertexData(int count)
+{
+    return (Vertex *)allocatePageAligned(count * sizeof(Vertex));
+}
+
+TriangleIndices *allocateIndexData(int count)
+{
+    return (TriangleIndices *)allocatePageAligned(count * sizeof(TriangleIndices));
+}
+
+size_t getPageAlignedLength(const void *data, size_t length)
+{
+    const size_t pageSize = getpagesize();
+    if (data == NULL || length == 0 || ((uintptr_t)data & (pageSize - 1)) != 0) { return 0; }
+    const size_t alignedLength = (length + pageSize - 1) & ~(pageSize - 1);
+    // only blocks that really extend to the page boundary can be wrapped
+    return malloc_size(data) >= alignedLength ? alignedLength : 0;
 }
 
 void combineIndexGeometryData(GeometryData *dest, GeometryData *src, int destPreCombineVertexCount)
 {
+    makeGeometryDataResizable(dest);
+
     if (src->indexCount > 0) {
         if (dest->indexCount > 0) {
             int totalCount = src->indexCount + dest->indexCount;
@@ -68,6 +163,8 @@ void combineIndexGeometryData(GeometryData *dest, GeometryData *src, int destPre
 
 void addTrianglesToGeometryData(GeometryData *dest, TriangleIndices *triangles, int triangleCount)
 {
+    makeGeometryDataResizable(dest);
+
     if (triangleCount > 0) {
         if (dest->indexCount > 0) {
             int totalCount = triangleCount + dest->indexCount;
@@ -87,6 +184,8 @@ void addTrianglesToGeometryData(GeometryData *dest, TriangleIndices *triangles,
 
 void combineGeometryData(GeometryData *dest, GeometryData *src)
 {
+    makeGeometryDataResizable(dest);
+
     int destPreCombineVertexCount = dest->vertexCount;
 
     if (src->vertexCount > 0) {
@@ -129,6 +228,8 @@ void combineGeometryDataAndTriangleFaceMap(GeometryData *destGeo, GeometryData *
 
 void combineAndOffsetGeometryData(GeometryData *dest, GeometryData *src, simd_float3 offset)
 {
+    makeGeometryDataResizable(dest);
+
     int destPreCombineVertexCount = dest->vertexCount;
 
     if (src->vertexCount > 0) {
@@ -157,6 +258,8 @@ void combineAndOffsetGeometryData(GeometryData *dest, GeometryData *src, simd_fl
 
 void combineAndScaleGeometryData(GeometryData *dest, GeometryData *src, simd_float3 scale)
 {
+    makeGeometryDataResizable(dest);
+
     int destPreCombineVertexCount = dest->vertexCount;
 
     if (src->vertexCount > 0) {
@@ -186,6 +289,8 @@ void combineAndScaleGeometryData(GeometryData *dest, GeometryData *src, simd_flo
 void combineAndScaleAndOffsetGeometryData(GeometryData *dest, GeometryData *src, simd_float3 scale,
                                           simd_float3 offset)
 {
+    makeGeometryDataResizable(dest);
+
     int destPreCombineVertexCount = dest->vertexCount;
 
     if (src->vertexCount > 0) {
@@ -216,6 +321,8 @@ void combineAndScaleAndOffsetGeometryData(GeometryData *dest, GeometryData *src,
 
 void combineAndTransformGeometryData(GeometryData *dest, GeometryData *src, simd_float4x4 transform)
 {
+    makeGeometryDataResizable(dest);
+
     int destPreCombineVertexCount = dest->vertexCount;
     simd_float4x4 rotation = simd_transpose(simd_inverse(transform));
     simd_float3x3 rot =
@@ -251,6 +358,9 @@ void combineAndTransformGeometryData(GeometryData *dest, GeometryData *src, simd
 void copyGeometryVertexData(GeometryData *dest, GeometryData *src, int start, int count)
 {
     if (src->vertexCount > 0) {
+        // dest's other array stays, so its storage has to be ours before one array is replaced
+        makeGeometryDataResizable(dest);
+        if (dest->vertexData != NULL) { free(dest->vertexData); }
         dest->vertexCount = count;
         dest->vertexData = (Vertex *)malloc(count * sizeof(Vertex));
         memcpy(dest->vertexData, src->vertexData + start, count * sizeof(Vertex));
@@ -260,6 +370,8 @@ void copyGeometryVertexData(GeometryData *dest, GeometryData *src, int start, in
 void copyGeometryIndexData(GeometryData *dest, GeometryData *src, int start, int count)
 {
     if (src->indexCount > 0) {
+        makeGeometryDataResizable(dest);
+        if (dest->indexData != NULL) { free(dest->indexData); }
         dest->indexCount = count;
         dest->indexData = (TriangleIndices *)malloc(sizeof(TriangleIndices) * count);
         memcpy(dest->indexData, src->indexData + start, count * sizeof(TriangleIndices));
@@ -268,7 +380,7 @@ void copyGeometryIndexData(GeometryData *dest, GeometryData *src, int start, int
 
 void copyGeometryData(GeometryData *dest, GeometryData *src)
 {
-
+    freeGeometryData(dest);
     copyGeometryVertexData(dest, src, 0, src->vertexCount);
     copyGeometryIndexData(dest, src, 0, src->indexCount);
 }
@@ -401,8 +513,8 @@ void deindexGeometryData(GeometryData *dest, GeometryData *src)
         vertexIndex += 1;
     }
 
-    dest->indexCount = 0;
-    dest->indexData = NULL;
+    // src may be dest, so its storage is only released once the new vertices are built
+    freeGeometryData(dest);
     dest->vertexCount = vertexIndex;
     dest->vertexData = vertices;
 }
@@ -440,8 +552,8 @@ void unrollGeometryData(GeometryData *dest, GeometryData *src)
             (Vertex) { .position = v2.position, .normal = normal, .uv = v2.uv };
     }
 
-    dest->indexCount = 0;
-    dest->indexData = NULL;
+    // src may be dest, so its storage is only released once the new vertices are built
+    freeGeometryData(dest);
     dest->vertexCount = vertexIndex;
     dest->vertexData = vertices;
 }
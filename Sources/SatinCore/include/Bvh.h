@@ -14,7 +14,12 @@
 extern "C" {
 #endif
 
+// References the geometry's positions and triangles in place, they have to outlive the BVH
 BVH createBVH(GeometryData geometry, bool useSAH);
+// triangles may be NULL for unindexed positions, the BVH's geometry is left empty so Swift
+// intersections only report positions, normals and barycentrics (uvs are zero)
+BVH createBVHFromPositions(const void *positions, uint32_t positionStride, int vertexCount,
+                           const TriangleIndices *triangles, int triangleCount, bool useSAH);
 void freeBVH(BVH bvh);
 
 #if defined(__cplusplus)
@@ -0,0 +1,53 @@
+//
+//  Curve.h
+//  Satin
+//
+//  Created by agent on 10/19/26.
+//
+
+#ifndef Curve_h
+#define Curve_h
+
+#import "Types.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+int getCurveSegmentCount(Curve3D curve);
+
+// u runs from 0 to the number of segments
+simd_float3 evaluateCurve3(Curve3D curve, float u);
+simd_float3 evaluateCurveVelocity3(Curve3D curve, float u);
+
+void evaluateCurvePositions(Curve3D curve, const float *params, int count,
+                            simd_float3 *positions);
+
+CurveLUT createCurveLUT(Curve3D curve, int samplesPerSegment);
+void freeCurveLUT(CurveLUT *lut);
+
+float getCurveParameterAtLength(const CurveLUT *lut, float length);
+
+// Writes count samples evenly spaced by arc length, params or positions may be NULL
+void sampleCurveByLength(Curve3D curve, const CurveLUT *lut, int count, float *params,
+                         simd_float3 *positions);
+
+// Rotation minimizing frames (double reflection), params should be increasing
+void computeCurveFrames(Curve3D curve, const float *params, int count, CurveFrame *frames);
+
+// Sweeps a counter clockwise profile (x along the frame normal, y along the binormal), rings are
+// placed so neighbours turn less than angleLimit and are at most maxSegmentLength apart (when > 0)
+// angleLimit is clamped to 0.001 radians and a sweep has at most 65536 rings
+GeometryData generateSweepGeometryData(Curve3D curve, const CurveLUT *lut,
+                                       const simd_float2 *profile, int profileCount, bool closed,
+                                       float angleLimit, float maxSegmentLength);
+
+GeometryData generateCurveTubeGeometryData(Curve3D curve, const CurveLUT *lut, float radius,
+                                           int angularResolution, float angleLimit,
+                                           float maxSegmentLength);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* Curve_h */
@@ -28,9 +28,22 @@ GeometryData generateConeGeometryData(float radius, float height, int angularRes
 GeometryData generateCylinderGeometryData(float radius, float height, int angularResolution,
                                           int radialResolution, int verticalResolution);
 
+// Returns empty geometry when the grid doesn't fit in GeometryData, use the tiled path instead
 GeometryData generatePlaneGeometryData(float width, float height, int widthResolution,
                                        int heightResolution, int plane, bool centered);
 
+// Vertex and triangle counts of a grid, false when they overflow GeometryData's counts
+bool getGridGeometrySize(int64_t columns, int64_t rows, int *vertexCount, int *triangleCount);
+
+void getGridTileCounts(const GridTileParameters *parameters, int *columns, int *rows);
+// Tiles repeat their border vertices so each one is self contained, free with freeGeometryTile
+GeometryTile generateGridTile(const GridTileParameters *parameters, int tileX, int tileY);
+void freeGeometryTile(GeometryTile *tile);
+// Streams the tiles in row order, only one is alive at a time: each tile is freed once the
+// callback returns so anything worth keeping has to be moved out of it, returns the tile count
+int64_t generateGridTiles(const GridTileParameters *parameters, GeometryTileCallback callback,
+                          void *context);
+
 GeometryData generateArcGeometryData(float innerRadius, float outerRadius, float startAngle,
                                      float endAngle, int angularResolution, int radialResolution);
 
@@ -86,6 +86,48 @@ float angle(float x, float y);
 
 simd_float3 getBarycentricCoordinates(simd_float3 p, simd_float3 a, simd_float3 b, simd_float3 c);
 
+// Packet Intersections: one ray or segment against 4 / 8 primitives stored as structure of arrays.
+// Each returns a bit mask of the lanes that hit, the nearest hit time & lane are written when there
+// is a hit (time & lane may be NULL). The Scalar variants test the same packets lane by lane and
+// produce identical results. Triangle hits require t > FLT_EPSILON, bounds hits require the exit
+// time to be >= 0 and report the entry time. Zeroed triangle lanes & empty bounds lanes never hit.
+// BVH traversal doesn't use them yet, its leaves are still tested a triangle at a time.
+
+TrianglePacket4 createTrianglePacket4(void);
+TrianglePacket8 createTrianglePacket8(void);
+BoundsPacket4 createBoundsPacket4(void);
+BoundsPacket8 createBoundsPacket8(void);
+EdgePacket4 createEdgePacket4(void);
+
+void setTrianglePacket4(TrianglePacket4 *packet, int lane, simd_float3 p0, simd_float3 p1,
+                        simd_float3 p2);
+void setTrianglePacket8(TrianglePacket8 *packet, int lane, simd_float3 p0, simd_float3 p1,
+                        simd_float3 p2);
+void setBoundsPacket4(BoundsPacket4 *packet, int lane, Bounds bounds);
+void setBoundsPacket8(BoundsPacket8 *packet, int lane, Bounds bounds);
+void setEdgePacket4(EdgePacket4 *packet, int lane, simd_float2 a, simd_float2 b);
+
+int rayTrianglePacket4Intersect(Ray ray, const TrianglePacket4 *packet, float *time, int *lane);
+int rayTrianglePacket4IntersectScalar(Ray ray, const TrianglePacket4 *packet, float *time,
+                                      int *lane);
+int rayTrianglePacket8Intersect(Ray ray, const TrianglePacket8 *packet, float *time, int *lane);
+int rayTrianglePacket8IntersectScalar(Ray ray, const TrianglePacket8 *packet, float *time,
+                                      int *lane);
+
+int rayBoundsPacket4Intersect(Ray ray, const BoundsPacket4 *packet, float *time, int *lane);
+int rayBoundsPacket4IntersectScalar(Ray ray, const BoundsPacket4 *packet, float *time, int *lane);
+int rayBoundsPacket8Intersect(Ray ray, const BoundsPacket8 *packet, float *time, int *lane);
+int rayBoundsPacket8IntersectScalar(Ray ray, const BoundsPacket8 *packet, float *time, int *lane);
+
+// 2D predicates of segment ab against the points (cx, cy) or the edges of a packet, same
+// semantics as isLeft, isBetween & intersectsProper
+int isLeftPacket4(simd_float2 a, simd_float2 b, simd_float4 cx, simd_float4 cy);
+int isLeftPacket4Scalar(simd_float2 a, simd_float2 b, simd_float4 cx, simd_float4 cy);
+int isBetweenPacket4(simd_float2 a, simd_float2 b, simd_float4 cx, simd_float4 cy);
+int isBetweenPacket4Scalar(simd_float2 a, simd_float2 b, simd_float4 cx, simd_float4 cy);
+int intersectsProperPacket4(simd_float2 a, simd_float2 b, const EdgePacket4 *edges);
+int intersectsProperPacket4Scalar(simd_float2 a, simd_float2 b, const EdgePacket4 *edges);
+
 #if defined(__cplusplus)
 }
 #endif
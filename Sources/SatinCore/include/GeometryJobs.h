@@ -0,0 +1,54 @@
+//
+//  GeometryJobs.h
+//  Satin
+//
+//  Created by agent on 10/19/26.
+//
+
+#ifndef GeometryJobs_h
+#define GeometryJobs_h
+
+#import "Types.h"
+#import "Jobs.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+typedef GeometryData (*GeometryGenerator)(const void *parameters);
+
+// Every pointer handed to these jobs has to stay valid until the job has finished, the returned
+// handles must be released with releaseJob
+
+Job *submitGenerateGeometryJob(JobSystem *system, GeometryGenerator generator,
+                               const void *parameters, GeometryData *output, Job **dependencies,
+                               int dependencyCount);
+
+// Appends the sources to dest in order
+Job *submitCombineGeometryJob(JobSystem *system, GeometryData *dest, GeometryData *sources,
+                              int sourceCount, Job **dependencies, int dependencyCount);
+
+Job *submitComputeNormalsJob(JobSystem *system, GeometryData *data, Job **dependencies,
+                             int dependencyCount);
+
+Job *submitCreateBVHJob(JobSystem *system, GeometryData *data, bool useSAH, BVH *output,
+                        Job **dependencies, int dependencyCount);
+
+// generate -> normals (optional) -> BVH (when bvh isn't NULL), the returned job finishes after the
+// last stage, cancelling it cancels the stages that haven't started yet and waits for the running
+// one
+Job *submitGeometryPipeline(JobSystem *system, GeometryGenerator generator, const void *parameters,
+                            bool computeNormals, GeometryData *output, BVH *bvh, bool useSAH);
+
+// One job per tile, the callback (and the height function) run concurrently on the workers and
+// each tile is freed once its callback returns, the returned job finishes after the last tile,
+// cancelling it cancels the tiles that haven't started yet and waits for the running ones,
+// parameters are copied
+Job *submitGridTileJobs(JobSystem *system, const GridTileParameters *parameters,
+                        GeometryTileCallback callback, void *context);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* GeometryJobs_h */
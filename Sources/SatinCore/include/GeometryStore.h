@@ -0,0 +1,56 @@
+//
+//  GeometryStore.h
+//  Satin
+//
+//  Created by agent on 10/19/26.
+//
+
+#ifndef GeometryStore_h
+#define GeometryStore_h
+
+#import "Types.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+// Hashes vertex (padding excluded) and index contents, identical meshes hash equal
+uint64_t hashGeometryData(const GeometryData *data);
+
+// Interns meshes by content so identical ones share one reference counted copy, bounds and BVH.
+// Matching is exact: entries with equal hashes compare every vertex field and index bitwise,
+// ignoring the vertices' simd padding (so -0 and 0 differ). Thread safe.
+typedef struct GeometryStore GeometryStore;
+typedef struct GeometryStoreEntry GeometryStoreEntry;
+
+GeometryStore *createGeometryStore(bool useSAH);
+// Frees every entry, including the ones still referenced
+void freeGeometryStore(GeometryStore *store);
+
+// Takes data's storage (borrowed storage is copied) or frees it when an identical mesh is already
+// stored, data is left empty. The returned entry holds a reference for the caller.
+GeometryStoreEntry *internGeometryData(GeometryStore *store, GeometryData *data);
+// Same as internGeometryData but leaves data untouched, copying it when it's new
+GeometryStoreEntry *internGeometryDataCopy(GeometryStore *store, const GeometryData *data);
+
+void retainGeometryStoreEntry(GeometryStoreEntry *entry);
+// The last release frees the entry's geometry and BVH
+void releaseGeometryStoreEntry(GeometryStoreEntry *entry);
+
+// Borrowed view of the entry's geometry, valid while the entry is referenced, must not be modified
+GeometryData getGeometryStoreEntryData(const GeometryStoreEntry *entry);
+uint64_t getGeometryStoreEntryHash(const GeometryStoreEntry *entry);
+int getGeometryStoreEntryReferenceCount(const GeometryStoreEntry *entry);
+
+// Computed on first use and shared by every reference, the BVH's nodes are NULL for meshes
+// without triangles
+Bounds getGeometryStoreEntryBounds(GeometryStoreEntry *entry);
+const BVH *getGeometryStoreEntryBVH(GeometryStoreEntry *entry);
+
+GeometryStoreStats getGeometryStoreStats(const GeometryStore *store);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* GeometryStore_h */
@@ -15,6 +15,8 @@ extern "C" {
 #endif
 
 simd_float3 hermite3(simd_float3 m0, simd_float3 a, simd_float3 b, simd_float3 m1, float t);
+simd_float3 hermiteVelocity3(simd_float3 m0, simd_float3 a, simd_float3 b, simd_float3 m1,
+                             float t);
 
 #if defined(__cplusplus)
 }
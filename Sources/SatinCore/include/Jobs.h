@@ -0,0 +1,69 @@
+//
+//  Jobs.h
+//  Satin
+//
+//  Created by agent on 10/19/26.
+//
+
+#ifndef Jobs_h
+#define Jobs_h
+
+#import <stdbool.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+typedef struct JobSystem JobSystem;
+typedef struct Job Job;
+
+typedef void (*JobFunction)(void *context);
+
+typedef enum JobStatus {
+    JobStatusPending = 0, // waiting on dependencies
+    JobStatusQueued,
+    JobStatusRunning,
+    JobStatusCompleted,
+    JobStatusCancelled
+} JobStatus;
+
+// threadCount <= 0 uses one thread less than the number of cores (at least one), the thread count
+// is the bound on how many jobs run at once
+JobSystem *createJobSystem(int threadCount);
+// Finishes every submitted job before returning
+void freeJobSystem(JobSystem *system);
+int getJobSystemThreadCount(const JobSystem *system);
+
+// Runs once every dependency has completed, a cancelled dependency cancels the job. The returned
+// handle must be released with releaseJob
+Job *submitJob(JobSystem *system, JobFunction function, void *context, Job **dependencies,
+               int dependencyCount);
+
+// Waiting from inside a job runs other queued jobs instead of blocking the worker
+void waitForJob(Job *job);
+void waitForJobs(Job **jobs, int count);
+// A job is finished once it has run or been cancelled and its dependents were released, until
+// then a cancelled job reports JobStatusRunning while its onCancel runs
+bool isJobFinished(Job *job);
+JobStatus getJobStatus(Job *job);
+// Only jobs that have not started running can be cancelled
+bool cancelJob(Job *job);
+void releaseJob(Job *job);
+
+#if defined(__cplusplus)
+}
+
+#include <functional>
+
+// onCancel runs (once) if the job is cancelled instead of run, both closures are destroyed when
+// the job finishes
+Job *submitJobClosure(JobSystem *system, std::function<void()> work,
+                      std::function<void()> onCancel, Job **dependencies, int dependencyCount);
+
+// Splits [0, count) into chunks of at least grainSize, runs them on the workers and the calling
+// thread and returns once they're all done, system may be NULL to run inline
+void parallelFor(JobSystem *system, int count, int grainSize,
+                 const std::function<void(int begin, int end)> &body);
+#endif
+
+#endif /* Jobs_h */
@@ -0,0 +1,35 @@
+//
+//  Meshlet.h
+//  Satin
+//
+//  Created by agent on 10/19/26.
+//
+
+#ifndef Meshlet_h
+#define Meshlet_h
+
+#import "Types.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+// Greedily grows spatially coherent clusters over shared vertices, indexSize 1 limits clusters to
+// 256 vertices
+MeshletData buildMeshlets(const GeometryData *geometry, int maxVertices, int maxTriangles,
+                          int indexSize);
+void freeMeshletData(MeshletData *data);
+
+// Planes point inwards (xyz normal, w distance), Metal clip space depth (0 to 1)
+void extractFrustumPlanes(simd_float4x4 viewProjection, simd_float4 *planes);
+
+// Writes the indices of the meshlets that survive frustum (planes may be NULL) and normal cone
+// culling, everything has to be in the same space, returns the number written
+int cullMeshlets(const MeshletData *data, const simd_float4 *planes, int planeCount,
+                 simd_float3 cameraPosition, uint32_t *visible);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* Meshlet_h */
@@ -0,0 +1,93 @@
+//
+//  PointIndex.h
+//  Satin
+//
+//  Created by agent on 10/19/26.
+//
+
+#ifndef PointIndex_h
+#define PointIndex_h
+
+#import "Types.h"
+#import "Jobs.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+// Point ids are the points' indices in the arrays they were created from. Positions are read as
+// three floats every positionStride bytes (sizeof(Vertex) for vertices, 16 for simd_float3).
+// Every system parameter may be NULL to run on the calling thread.
+
+// Balanced k-d tree (median splits, all leaves at the same depth) that keeps a copy of the points
+// in leaf order. Moving points refits the node bounds in place, queries stay exact but slow down
+// as the points drift from where they were split, rebuildKdTree re-splits them.
+typedef struct KdTree KdTree;
+
+KdTree *createKdTree(const void *positions, uint32_t positionStride, int count,
+                     JobSystem *system);
+KdTree *createKdTreeFromGeometry(const GeometryData *geometry, JobSystem *system);
+void freeKdTree(KdTree *tree);
+void rebuildKdTree(KdTree *tree, JobSystem *system);
+
+int getKdTreeCount(const KdTree *tree);
+Bounds getKdTreeBounds(const KdTree *tree);
+simd_float3 getKdTreePoint(const KdTree *tree, uint32_t id);
+
+void updateKdTreePoint(KdTree *tree, uint32_t id, simd_float3 position);
+// When ids is NULL positions holds every point in id order and count is ignored
+void updateKdTreePoints(KdTree *tree, const void *positions, uint32_t positionStride,
+                        const uint32_t *ids, int count, JobSystem *system);
+
+// Writes the (up to) k nearest ids within maxDistance (INFINITY for no limit) sorted by
+// distance, distances may be NULL, returns the number written
+int queryKdTreeNearest(const KdTree *tree, simd_float3 point, int k, float maxDistance,
+                       uint32_t *results, float *distances);
+// Writes up to capacity ids within radius (unsorted) and returns the total number of matches,
+// distances may be NULL
+int queryKdTreeRadius(const KdTree *tree, simd_float3 point, float radius, uint32_t *results,
+                      float *distances, int capacity);
+
+// Batches hold k (or capacity) result slots per query, counts gets each query's return value
+void queryKdTreeNearestBatch(const KdTree *tree, const simd_float3 *points, int count, int k,
+                             float maxDistance, uint32_t *results, float *distances, int *counts,
+                             JobSystem *system);
+void queryKdTreeRadiusBatch(const KdTree *tree, const simd_float3 *points, int count,
+                            float radius, uint32_t *results, float *distances, int capacity,
+                            int *counts, JobSystem *system);
+
+// Spatial hash of uniform cells, cheap to rebuild every frame and suited to radius queries
+// close to the cell size. A point that moves into another cell re-bins the whole grid.
+typedef struct PointGrid PointGrid;
+
+PointGrid *createPointGrid(const void *positions, uint32_t positionStride, int count,
+                           float cellSize, JobSystem *system);
+PointGrid *createPointGridFromGeometry(const GeometryData *geometry, float cellSize,
+                                       JobSystem *system);
+void freePointGrid(PointGrid *grid);
+
+int getPointGridCount(const PointGrid *grid);
+float getPointGridCellSize(const PointGrid *grid);
+simd_float3 getPointGridPoint(const PointGrid *grid, uint32_t id);
+
+void updatePointGridPoint(PointGrid *grid, uint32_t id, simd_float3 position);
+void updatePointGridPoints(PointGrid *grid, const void *positions, uint32_t positionStride,
+                           const uint32_t *ids, int count, JobSystem *system);
+
+int queryPointGridNearest(const PointGrid *grid, simd_float3 point, int k, float maxDistance,
+                          uint32_t *results, float *distances);
+int queryPointGridRadius(const PointGrid *grid, simd_float3 point, float radius,
+                         uint32_t *results, float *distances, int capacity);
+
+void queryPointGridNearestBatch(const PointGrid *grid, const simd_float3 *points, int count, int k,
+                                float maxDistance, uint32_t *results, float *distances,
+                                int *counts, JobSystem *system);
+void queryPointGridRadiusBatch(const PointGrid *grid, const simd_float3 *points, int count,
+                               float radius, uint32_t *results, float *distances, int capacity,
+                               int *counts, JobSystem *system);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* PointIndex_h */
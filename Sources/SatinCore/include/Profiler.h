@@ -0,0 +1,130 @@
+//
+//  Profiler.h
+//  Satin
+//
+//  Created by agent on 10/19/26.
+//
+
+#ifndef Profiler_h
+#define Profiler_h
+
+#import <stdbool.h>
+#import <stdint.h>
+
+#import "Types.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+typedef enum ProfileCounter {
+    ProfileCounterTriangulatorEarTests = 0,
+    ProfileCounterTriangulatorDiagonalEdgeChecks,
+    ProfileCounterTriangulatorHoleBridges,
+    ProfileCounterTriangulatorFailures,
+    ProfileCounterBVHNodesBuilt,
+    ProfileCounterBVHSAHEvaluations,
+    ProfileCounterBVHRays,
+    ProfileCounterBVHNodesVisited,
+    ProfileCounterBVHTrianglesTested,
+    ProfileCounterGeneratorCalls,
+    ProfileCounterGeneratedVertices,
+    ProfileCounterGeneratedTriangles,
+    ProfileCounterMeshletsBuilt,
+    ProfileCounterMeshletsCulled,
+    ProfileCounterCount
+} ProfileCounter;
+
+// Profiling is compiled in but disabled by default, when disabled every call below is a single
+// relaxed atomic load
+
+void setProfilingEnabled(bool enabled);
+bool isProfilingEnabled(void);
+
+void addProfileCounter(ProfileCounter counter, uint64_t value);
+uint64_t getProfileCounter(ProfileCounter counter);
+const char *getProfileCounterName(ProfileCounter counter);
+void resetProfileCounters(void);
+
+// Records the rays cast against a BVH and how much work each ray did, traversal lives in Swift
+void addBVHRayProfile(uint64_t nodesVisited, uint64_t trianglesTested);
+
+// Spans are recorded as complete events (ph: X), names must outlive the trace (string literals)
+uint64_t beginProfileSpan(void);
+void endProfileSpan(const char *name, uint64_t start);
+void endProfileSpanWithGeometry(const char *name, uint64_t start, int vertexCount,
+                                int triangleCount);
+
+// At most capacity spans are kept (262144 by default), later ones are dropped and counted until
+// the spans are cleared
+int getProfileSpanCount(void);
+uint64_t getDroppedProfileSpanCount(void);
+void setProfileSpanCapacity(int capacity);
+void clearProfileSpans(void);
+
+// Writes spans and counter totals as Chrome trace JSON (chrome://tracing, Perfetto)
+bool writeProfileTrace(const char *path);
+
+#if defined(__cplusplus)
+}
+
+class ProfileSpan {
+  public:
+    explicit ProfileSpan(const char *name) : name(name), start(beginProfileSpan()) {}
+    ~ProfileSpan() { end(); }
+
+    void end()
+    {
+        if (name == nullptr) { return; }
+        if (hasGeometry) { endProfileSpanWithGeometry(name, start, vertexCount, triangleCount); }
+        else {
+            endProfileSpan(name, start);
+        }
+        name = nullptr;
+    }
+
+    void setGeometry(int vertices, int triangles)
+    {
+        vertexCount = vertices;
+        triangleCount = triangles;
+        hasGeometry = true;
+    }
+
+  private:
+    ProfileSpan(const ProfileSpan &) = delete;
+    ProfileSpan &operator=(const ProfileSpan &) = delete;
+
+    const char *name;
+    uint64_t start;
+    int vertexCount = 0;
+    int triangleCount = 0;
+    bool hasGeometry = false;
+};
+
+// Generators call each other, only the outermost call adds to the generated geometry counters
+int enterGeneratorProfile(void);
+void exitGeneratorProfile(void);
+
+class GeneratorProfileSpan {
+  public:
+    explicit GeneratorProfileSpan(const char *name) : span(name), depth(enterGeneratorProfile()) {}
+    ~GeneratorProfileSpan() { exitGeneratorProfile(); }
+
+    GeometryData finish(GeometryData data)
+    {
+        span.setGeometry(data.vertexCount, data.indexCount);
+        if (depth == 1) {
+            addProfileCounter(ProfileCounterGeneratorCalls, 1);
+            addProfileCounter(ProfileCounterGeneratedVertices, data.vertexCount);
+            addProfileCounter(ProfileCounterGeneratedTriangles, data.indexCount);
+        }
+        return data;
+    }
+
+  private:
+    ProfileSpan span;
+    int depth;
+};
+#endif
+
+#endif /* Profiler_h */
@@ -0,0 +1,44 @@
+//
+//  RTree.h
+//  Satin
+//
+//  Created by agent on 10/19/26.
+//
+
+#ifndef RTree_h
+#define RTree_h
+
+#import "Types.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+typedef struct RTree RTree;
+
+// Bulk loads (Sort-Tile-Recursive) an R-tree, when ids is NULL rectangle i gets id i
+RTree *createRTree(const Rectangle *rects, const uint32_t *ids, int count);
+void freeRTree(RTree *tree);
+
+int getRTreeCount(const RTree *tree);
+Rectangle getRTreeBounds(const RTree *tree);
+
+// Inserting an id that is already in the tree updates it
+void insertRTree(RTree *tree, uint32_t id, Rectangle rect);
+bool removeRTree(RTree *tree, uint32_t id);
+bool updateRTree(RTree *tree, uint32_t id, Rectangle rect);
+
+// Queries write up to capacity ids into results and return the total number of matches
+int queryRTreePoint(const RTree *tree, simd_float2 pt, uint32_t *results, int capacity);
+int queryRTreeRectangle(const RTree *tree, Rectangle rect, uint32_t *results, int capacity);
+
+// Writes the (up to) k nearest ids sorted by distance to their rectangles (0 when inside),
+// distances may be NULL, returns the number written
+int queryRTreeNearest(const RTree *tree, simd_float2 pt, int k, uint32_t *results,
+                      float *distances);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* RTree_h */
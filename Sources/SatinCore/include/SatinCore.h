@@ -13,7 +13,15 @@
 #import "Generators.h"
 #import "Bezier.h"
 #import "Hermite.h"
+#import "Curve.h"
 #import "Bounds.h"
 #import "Rectangle.h"
+#import "RTree.h"
 #import "Triangulator.h"
 #import "Bvh.h"
+#import "PointIndex.h"
+#import "GeometryStore.h"
+#import "Meshlet.h"
+#import "Jobs.h"
+#import "GeometryJobs.h"
+#import "Profiler.h"
@@ -58,13 +58,106 @@ typedef struct TriangleFaceMap {
     uint32_t *data;
 } TriangleFaceMap;
 
+typedef enum GeometryDataOwnership {
+    GeometryDataOwned = 0, // malloc'd, released with free
+    GeometryDataBorrowed,  // never released or resized by SatinCore
+    GeometryDataCustom     // released with the deleter
+} GeometryDataOwnership;
+
+typedef void (*GeometryDataDeleter)(void *data, void *context);
+
 typedef struct GeometryData {
     int vertexCount;
     Vertex *vertexData;
     int indexCount;
     TriangleIndices *indexData;
+    GeometryDataOwnership ownership;
+    GeometryDataDeleter deleter;
+    void *deleterContext;
 } GeometryData;
 
+// Structure of arrays packets for testing one ray or segment against several primitives at once
+
+typedef struct TrianglePacket4 {
+    simd_float4 v0x, v0y, v0z;
+    simd_float4 e1x, e1y, e1z;
+    simd_float4 e2x, e2y, e2z;
+} TrianglePacket4;
+
+typedef struct TrianglePacket8 {
+    simd_float8 v0x, v0y, v0z;
+    simd_float8 e1x, e1y, e1z;
+    simd_float8 e2x, e2y, e2z;
+} TrianglePacket8;
+
+typedef struct BoundsPacket4 {
+    simd_float4 minX, minY, minZ;
+    simd_float4 maxX, maxY, maxZ;
+} BoundsPacket4;
+
+typedef struct BoundsPacket8 {
+    simd_float8 minX, minY, minZ;
+    simd_float8 maxX, maxY, maxZ;
+} BoundsPacket8;
+
+typedef struct EdgePacket4 {
+    simd_float4 x0, y0;
+    simd_float4 x1, y1;
+} EdgePacket4;
+
+typedef enum CurveType {
+    CurveTypeHermite = 0, // tangents holds one tangent per point
+    CurveTypeCatmullRom,
+    CurveTypeQuadraticBezier, // segments share end points: a b c d e
+    CurveTypeCubicBezier      // a b c d e f g
+} CurveType;
+
+typedef struct Curve3D {
+    CurveType type;
+    int count;
+    const simd_float3 *points;
+    const simd_float3 *tangents;
+} Curve3D;
+
+// Cumulative arc lengths sampled uniformly in the curve parameter, which runs from 0 to the
+// number of segments
+typedef struct CurveLUT {
+    int segmentCount;
+    int samplesPerSegment;
+    int count;
+    float *lengths;
+    float length;
+} CurveLUT;
+
+typedef struct CurveFrame {
+    simd_float3 position;
+    simd_float3 tangent;
+    simd_float3 normal;
+    simd_float3 binormal;
+} CurveFrame;
+
+typedef struct Meshlet {
+    uint32_t vertexOffset;
+    uint32_t vertexCount;
+    uint32_t triangleOffset;
+    uint32_t triangleCount;
+    Bounds bounds;
+    simd_float4 sphere; // center, radius
+    simd_float4 cone;   // axis, cutoff (1 when the cluster can't be backface culled)
+} Meshlet;
+
+// vertices maps meshlet local vertices to the source geometry's vertices, triangles holds three
+// local indices per triangle, each indexSize (1 or 2) bytes
+typedef struct MeshletData {
+    int meshletCount;
+    Meshlet *meshlets;
+    int vertexCount;
+    uint32_t *vertices;
+    int triangleCount;
+    int indexSize;
+    void *triangles;
+} MeshletData;
+
 typedef struct BVHNode {
     Bounds aabb;
     uint32_t leftFirst;
@@ -75,19 +168,82 @@ typedef struct BVH {
     GeometryData geometry;
     BVHNode *nodes;
     simd_float3 *centroids;
-    simd_float3 *positions;
-    TriangleIndices *triangles;
+    const void *positions; // read in place, three floats every positionStride bytes
+    uint32_t positionStride;
+    const TriangleIndices *triangles;
+    bool ownsTriangles;
     uint32_t *triIDs;
     uint32_t nodesUsed;
     bool useSAH;
 } BVH;
 
+typedef float (*GridHeightFunction)(simd_float2 uv, void *context);
+
+// A plane grid (see generatePlaneGeometryData) split into square tiles of tileResolution cells,
+// the optional height function displaces the grid along the plane's normal
+typedef struct GridTileParameters {
+    float width;
+    float height;
+    int widthResolution;
+    int heightResolution;
+    int plane;
+    bool centered;
+    int tileResolution;
+    GridHeightFunction heightFunction;
+    void *heightContext;
+    bool buildBVH;
+    bool useSAH;
+} GridTileParameters;
+
+typedef struct GeometryTile {
+    int tileX;
+    int tileY;
+    int column; // first grid cell covered by the tile
+    int row;
+    int columns;
+    int rows;
+    Bounds bounds;
+    GeometryData geometry; // indices are local to the tile
+    BVH bvh;               // nodes is NULL unless buildBVH was set
+} GeometryTile;
+
+typedef void (*GeometryTileCallback)(GeometryTile *tile, void *context);
+
+// Bytes count vertex & index data, and BVH memory for the saved figures
+typedef struct GeometryStoreStats {
+    int entryCount;          // unique meshes
+    int referenceCount;      // live references across every entry
+    int64_t internCount;     // intern calls
+    int64_t hitCount;        // intern calls answered by an existing entry
+    int bvhCount;            // shared BVHs built
+    int64_t bvhRequestCount; // BVH requests, every one past the first per entry is a saved build
+    size_t uniqueBytes;      // held by the store
+    size_t referencedBytes;  // every reference holding its own copy would need
+    size_t savedBytes;       // referencedBytes - uniqueBytes plus the BVHs shared across references
+    float dedupRatio;        // referencedBytes / uniqueBytes
+} GeometryStoreStats;
+
 TriangleFaceMap createTriangleFaceMap(void);
 void freeTriangleFaceMap(TriangleFaceMap *map);
 
 GeometryData createGeometryData(void);
+// Wraps caller provided storage, a NULL deleter borrows it
+GeometryData createGeometryDataWithStorage(Vertex *vertexData, int vertexCount,
+                                           TriangleIndices *indexData, int indexCount,
+                                           GeometryDataDeleter deleter, void *deleterContext);
 void freeGeometryData(GeometryData *data);
+// Copies borrowed or custom storage into malloc'd storage so it can be resized
+void makeGeometryDataResizable(GeometryData *data);
+
+// Large arrays start on a page and are padded to whole pages so Metal can wrap them without a
+// copy, both are released with free
+Vertex *allocateVertexData(int count);
+TriangleIndices *allocateIndexData(int count);
+// Length a page aligned malloc'd block can be wrapped with, 0 when it can't be wrapped
+size_t getPageAlignedLength(const void *data, size_t length);
 
+// The copy, deindex and unroll functions release dest's previous storage, so dest has to be
+// initialized (createGeometryData) before it is passed in
 void copyGeometryVertexData(GeometryData *dest, GeometryData *src, int start, int end);
 void copyGeometryIndexData(GeometryData *dest, GeometryData *src, int start, int end);
 void copyGeometryData(GeometryData *dest, GeometryData *src);
@@ -102,6 +258,8 @@ void combineAndScaleAndOffsetGeometryData(GeometryData *dest, GeometryData *src,
 void combineAndTransformGeometryData(GeometryData *dest, GeometryData *src,
                                      simd_float4x4 transform);
 
+// These write through data's arrays in place, borrowed and custom storage included, call
+// makeGeometryDataResizable first to work on a private copy
 void computeNormalsOfGeometryData(GeometryData *data);
 void reverseFacesOfGeometryData(GeometryData *data);
 
@@ -0,0 +1,100 @@
+//
+//  CurveTests.swift
+//
+//
+//  Created by agent on 10/19/26.
+//
+
+import SatinCore
+import simd
+import XCTest
+
+class CurveTests: XCTestCase {
+    // cubic bezier approximation of a quarter circle
+    let quarterCircle: [simd_float3] = [
+        .init(1, 0, 0), .init(1, 0.5522847, 0), .init(0.5522847, 1, 0), .init(0, 1, 0),
+    ]
+
+    func testArcLength() {
+        quarterCircle.withUnsafeBufferPointer { points in
+            let curve = Curve3D(type: CurveTypeCubicBezier, count: 4, points: points.baseAddress, tangents: nil)
+            XCTAssertEqual(getCurveSegmentCount(curve), 1)
+
+            var lut = createCurveLUT(curve, 16)
+            defer { freeCurveLUT(&lut) }
+            XCTAssertEqual(lut.length, Float.pi * 0.5, accuracy: 1e-3)
+
+            let p = evaluateCurve3(curve, 0.3)
+            XCTAssertEqual(simd_distance(p, cubicBezier3(quarterCircle[0], quarterCircle[1], quarterCircle[2], quarterCircle[3], 0.3)), 0, accuracy: 1e-5)
+            let v = evaluateCurveVelocity3(curve, 0.3)
+            XCTAssertEqual(simd_distance(v, cubicBezierVelocity3(quarterCircle[0], quarterCircle[1], quarterCircle[2], quarterCircle[3], 0.3)), 0, accuracy: 1e-5)
+
+            var params = [Float](repeating: 0, count: 9)
+            var positions = [simd_float3](repeating: .zero, count: 9)
+            sampleCurveByLength(curve, &lut, 9, &params, &positions)
+            XCTAssertEqual(params.first!, 0)
+            XCTAssertEqual(params.last!, 1)
+            for i in 1 ..< 9 {
+                // evenly spaced by arc length means evenly spaced angles on the circle
+                XCTAssertEqual(simd_distance(positions[i], positions[i - 1]), 2 * sin(Float.pi / 32), accuracy: 2e-3)
+            }
+        }
+    }
+
+    func testFramesAreOrthonormal() {
+        let points: [simd_float3] = (0 ..< 16).map { simd_float3(cos(Float($0) * 0.7), sin(Float($0) * 0.7), Float($0) * 0.3) }
+        points.withUnsafeBufferPointer { points in
+            let curve = Curve3D(type: CurveTypeCatmullRom, count: 16, points: points.baseAddress, tangents: nil)
+            let params = (0 ..< 200).map { Float($0) * 15 / 199 }
+            var frames = [CurveFrame](repeating: CurveFrame(), count: params.count)
+            computeCurveFrames(curve, params, Int32(params.count), &frames)
+
+            for frame in frames {
+                XCTAssertEqual(simd_length(frame.tangent), 1, accuracy: 1e-4)
+                XCTAssertEqual(simd_length(frame.normal), 1, accuracy: 1e-4)
+                XCTAssertEqual(simd_dot(frame.tangent, frame.normal), 0, accuracy: 1e-4)
+                XCTAssertEqual(simd_dot(frame.binormal, frame.normal), 0, accuracy: 1e-4)
+            }
+        }
+    }
+
+    func testTubeResolutionFollowsCurvature() {
+        let line: [simd_float3] = [.init(0, 0, 0), .init(0, 0, 10)]
+        line.withUnsafeBufferPointer { points in
+            let curve = Curve3D(type: CurveTypeCatmullRom, count: 2, points: points.baseAddress, tangents: nil)
+            var lut = createCurveLUT(curve, 8)
+            defer { freeCurveLUT(&lut) }
+
+            // a straight line only needs its end rings
+            var tube = generateCurveTubeGeometryData(curve, &lut, 0.5, 12, 0.1, 0)
+            XCTAssertEqual(tube.vertexCount, 2 * 13)
+            XCTAssertEqual(tube.indexCount, 12 * 2)
+            freeGeometryData(&tube)
+
+            tube = generateCurveTubeGeometryData(curve, &lut, 0.5, 12, 0.1, 1.1)
+            XCTAssertEqual(tube.vertexCount, 11 * 13)
+            freeGeometryData(&tube)
+        }
+
+        quarterCircle.withUnsafeBufferPointer { points in
+            let curve = Curve3D(type: CurveTypeCubicBezier, count: 4, points: points.baseAddress, tangents: nil)
+            var lut = createCurveLUT(curve, 32)
+            defer { freeCurveLUT(&lut) }
+
+            var coarse = generateCurveTubeGeometryData(curve, &lut, 0.1, 8, 0.5, 0)
+            var fine = generateCurveTubeGeometryData(curve, &lut, 0.1, 8, 0.05, 0)
+            XCTAssertGreaterThan(fine.vertexCount, coarse.vertexCount)
+
+            // outward facing triangles
+            for i in 0 ..< Int(fine.indexCount) {
+                let tri = fine.indexData[i]
+                let v0 = fine.vertexData[Int(tri.i0)], v1 = fine.vertexData[Int(tri.i1)], v2 = fine.vertexData[Int(tri.i2)]
+                let n = simd_cross(simd_make_float3(v1.position - v0.position), simd_make_float3(v2.position - v0.position))
+                XCTAssertGreaterThan(simd_dot(n, v0.normal + v1.normal + v2.normal), 0)
+            }
+
+            freeGeometryData(&coarse)
+            freeGeometryData(&fine)
+        }
+    }
+}
@@ -0,0 +1,121 @@
+//
+//  GeometryDataTests.swift
+//
+//
+//  Created by agent on 10/19/26.
+//
+
+import SatinCore
+import simd
+import XCTest
+
+class GeometryDataTests: XCTestCase {
+    func testCustomDeleter() {
+        var released: Int32 = 0
+        let deleter: GeometryDataDeleter = { data, context in
+            free(data)
+            context!.assumingMemoryBound(to: Int32.self).pointee += 1
+        }
+
+        withUnsafeMutablePointer(to: &released) { counter in
+            var box = generateBoxGeometryData(1, 1, 1, 0, 0, 0, 1, 1, 1)
+            var data = createGeometryDataWithStorage(box.vertexData, box.vertexCount, box.indexData, box.indexCount, deleter, counter)
+            box = createGeometryData()
+
+            XCTAssertEqual(data.ownership, GeometryDataCustom)
+            freeGeometryData(&data)
+            XCTAssertEqual(data.vertexCount, 0)
+            XCTAssertEqual(data.ownership, GeometryDataOwned)
+        }
+
+        XCTAssertEqual(released, 2)
+    }
+
+    func testBorrowedStorageIsCopiedBeforeResizing() {
+        var box = generateBoxGeometryData(1, 1, 1, 0, 0, 0, 1, 1, 1)
+        defer { freeGeometryData(&box) }
+
+        var borrowed = createGeometryDataWithStorage(box.vertexData, box.vertexCount, box.indexData, box.indexCount, nil, nil)
+        combineGeometryData(&borrowed, &box)
+
+        XCTAssertEqual(borrowed.ownership, GeometryDataOwned)
+        XCTAssertNotEqual(borrowed.vertexData, box.vertexData)
+        XCTAssertEqual(borrowed.vertexCount, box.vertexCount * 2)
+        XCTAssertEqual(borrowed.indexCount, box.indexCount * 2)
+        freeGeometryData(&borrowed)
+
+        // borrowed storage is never released
+        var view = createGeometryDataWithStorage(box.vertexData, box.vertexCount, box.indexData, box.indexCount, nil, nil)
+        freeGeometryData(&view)
+        XCTAssertNil(view.vertexData)
+        XCTAssertEqual(box.vertexCount, 24)
+    }
+
+    func testCopiesReleaseDestinationStorage() {
+        var box = generateBoxGeometryData(1, 1, 1, 0, 0, 0, 1, 1, 1)
+        defer { freeGeometryData(&box) }
+
+        var released: Int32 = 0
+        let deleter: GeometryDataDeleter = { data, context in
+            free(data)
+            context!.assumingMemoryBound(to: Int32.self).pointee += 1
+        }
+
+        withUnsafeMutablePointer(to: &released) { counter in
+            var source = generatePlaneGeometryData(1, 1, 1, 1, 0, true)
+            var dest = createGeometryDataWithStorage(source.vertexData, source.vertexCount, source.indexData, source.indexCount, deleter, counter)
+            source = createGeometryData()
+
+            unrollGeometryData(&dest, &box)
+            XCTAssertEqual(counter.pointee, 2)
+            XCTAssertEqual(dest.ownership, GeometryDataOwned)
+            XCTAssertEqual(dest.vertexCount, box.indexCount * 3)
+            XCTAssertEqual(dest.indexCount, 0)
+            freeGeometryData(&dest)
+        }
+
+        // borrowed destinations are replaced, never written through
+        var view = createGeometryDataWithStorage(box.vertexData, box.vertexCount, box.indexData, box.indexCount, nil, nil)
+        copyGeometryData(&view, &box)
+        XCTAssertEqual(view.ownership, GeometryDataOwned)
+        XCTAssertNotEqual(view.vertexData, box.vertexData)
+        XCTAssertEqual(view.indexCount, box.indexCount)
+        freeGeometryData(&view)
+    }
+
+    func testPageAlignedGeneratorStorage() {
+        var plane = generatePlaneGeometryData(2, 2, 128, 128, 0, true)
+        defer { freeGeometryData(&plane) }
+
+        let pageSize = Int(getpagesize())
+        let length = Int(plane.vertexCount) * MemoryLayout<Vertex>.stride
+        XCTAssertEqual(Int(bitPattern: plane.vertexData) % pageSize, 0)
+        XCTAssertEqual(getPageAlignedLength(plane.vertexData, length), (length + pageSize - 1) / pageSize * pageSize)
+
+        let small = UnsafeMutablePointer<Vertex>.allocate(capacity: 1)
+        defer { small.deallocate() }
+        XCTAssertEqual(getPageAlignedLength(small, MemoryLayout<Vertex>.stride), 0)
+    }
+
+    func testBVHReadsPositionsInPlace() {
+        var sphere = generateSphereGeometryData(1, 24, 16)
+        defer { freeGeometryData(&sphere) }
+
+        let bvh = createBVH(sphere, true)
+        defer { freeBVH(bvh) }
+        XCTAssertEqual(bvh.positions, UnsafeRawPointer(sphere.vertexData))
+        XCTAssertEqual(bvh.positionStride, UInt32(MemoryLayout<Vertex>.stride))
+        XCTAssertEqual(bvh.triangles, UnsafePointer(sphere.indexData))
+
+        // tightly packed positions without indices
+        let packed: [Float] = [0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0, 1, 1, 0, 1, 0, 1, 1]
+        packed.withUnsafeBytes { bytes in
+            let packedBVH = createBVHFromPositions(bytes.baseAddress, 12, 6, nil, 0, false)
+            defer { freeBVH(packedBVH) }
+            XCTAssertEqual(packedBVH.positions, bytes.baseAddress)
+            XCTAssertEqual(packedBVH.positionStride, 12)
+            XCTAssertEqual(packedBVH.geometry.vertexCount, 0)
+            XCTAssertEqual(packedBVH.nodes[0].aabb.max, simd_float3(1, 1, 1))
+        }
+    }
+}
@@ -0,0 +1,72 @@
+//
+//  GeometryStoreTests.swift
+//
+//
+//  Created by agent on 10/19/26.
+//
+
+import SatinCore
+import simd
+import XCTest
+
+class GeometryStoreTests: XCTestCase {
+    func testHashIgnoresPadding() {
+        var a = generateBoxGeometryData(1, 1, 1, 0, 0, 0, 2, 2, 2)
+        var b = createGeometryData()
+        copyGeometryData(&b, &a)
+        defer {
+            freeGeometryData(&a)
+            freeGeometryData(&b)
+        }
+
+        // scribble over the normal's padding lane
+        let raw = UnsafeMutableRawPointer(b.vertexData!)
+        raw.storeBytes(of: Float.nan, toByteOffset: 28, as: Float.self)
+        XCTAssertEqual(hashGeometryData(&a), hashGeometryData(&b))
+
+        b.vertexData[0].uv.x += 1
+        XCTAssertNotEqual(hashGeometryData(&a), hashGeometryData(&b))
+    }
+
+    func testInterningSharesStorageAndBVH() {
+        let store = createGeometryStore(true)
+        defer { freeGeometryStore(store) }
+
+        var entries: [OpaquePointer?] = (0 ..< 10).map { _ in
+            var box = generateBoxGeometryData(1, 2, 3, 0, 0, 0, 4, 4, 4)
+            let entry = internGeometryData(store, &box)
+            XCTAssertEqual(box.vertexCount, 0)
+            return entry
+        }
+        var sphere = generateSphereGeometryData(1, 16, 8)
+        entries.append(internGeometryDataCopy(store, &sphere))
+        freeGeometryData(&sphere)
+
+        XCTAssertTrue(entries.prefix(10).allSatisfy { $0 == entries[0] })
+        XCTAssertNotEqual(entries[0], entries[10])
+        XCTAssertEqual(getGeometryStoreEntryReferenceCount(entries[0]), 10)
+
+        let bvh = getGeometryStoreEntryBVH(entries[0])
+        XCTAssertEqual(getGeometryStoreEntryBVH(entries[9]), bvh)
+        XCTAssertEqual(getGeometryStoreEntryBounds(entries[3]).max, simd_float3(0.5, 1, 1.5))
+
+        let data = getGeometryStoreEntryData(entries[0])
+        XCTAssertEqual(data.ownership, GeometryDataBorrowed)
+        XCTAssertEqual(bvh?.pointee.positions, UnsafeRawPointer(data.vertexData))
+
+        var stats = getGeometryStoreStats(store)
+        XCTAssertEqual(stats.entryCount, 2)
+        XCTAssertEqual(stats.referenceCount, 11)
+        XCTAssertEqual(stats.internCount, 11)
+        XCTAssertEqual(stats.hitCount, 9)
+        XCTAssertEqual(stats.bvhCount, 1)
+        XCTAssertEqual(stats.bvhRequestCount, 2)
+        XCTAssertGreaterThan(stats.dedupRatio, 5)
+        XCTAssertGreaterThan(stats.savedBytes, stats.referencedBytes - stats.uniqueBytes)
+
+        entries.forEach { releaseGeometryStoreEntry($0) }
+        stats = getGeometryStoreStats(store)
+        XCTAssertEqual(stats.entryCount, 0)
+        XCTAssertEqual(stats.uniqueBytes, 0)
+    }
+}
@@ -0,0 +1,116 @@
+//
+//  GridTileTests.swift
+//
+//
+//  Created by agent on 10/19/26.
+//
+
+import SatinCore
+import simd
+import XCTest
+
+class GridTileTests: XCTestCase {
+    func makeParameters(tileResolution: Int32) -> GridTileParameters {
+        GridTileParameters(
+            width: 10, height: 6,
+            widthResolution: 50, heightResolution: 30,
+            plane: 2, centered: true,
+            tileResolution: tileResolution,
+            heightFunction: nil, heightContext: nil,
+            buildBVH: true, useSAH: false
+        )
+    }
+
+    func testTilesMatchMonolithicPlane() {
+        var parameters = makeParameters(tileResolution: 16)
+        var plane = generatePlaneGeometryData(10, 6, 50, 30, 2, true)
+        defer { freeGeometryData(&plane) }
+
+        var columns: Int32 = 0
+        var rows: Int32 = 0
+        getGridTileCounts(&parameters, &columns, &rows)
+        XCTAssertEqual(columns, 4)
+        XCTAssertEqual(rows, 2)
+
+        var triangles = 0
+        for y in 0 ..< rows {
+            for x in 0 ..< columns {
+                var tile = generateGridTile(&parameters, x, y)
+                defer { freeGeometryTile(&tile) }
+
+                triangles += Int(tile.geometry.indexCount)
+                XCTAssertGreaterThan(tile.bvh.nodesUsed, 0)
+
+                // tile corners land on the same vertices as the full plane
+                let perRow = Int(tile.columns) + 1
+                let last = Int(tile.geometry.vertexCount) - 1
+                let first = Int(tile.row) * 51 + Int(tile.column)
+                let end = (Int(tile.row + tile.rows)) * 51 + Int(tile.column + tile.columns)
+                XCTAssertEqual(tile.geometry.vertexData[0].position, plane.vertexData[first].position)
+                XCTAssertEqual(tile.geometry.vertexData[last].position, plane.vertexData[end].position)
+                XCTAssertEqual(tile.geometry.vertexData[last].uv, plane.vertexData[end].uv)
+                XCTAssertEqual(last + 1, perRow * (Int(tile.rows) + 1))
+            }
+        }
+        XCTAssertEqual(triangles, Int(plane.indexCount))
+    }
+
+    func testStreamingAndParallelTiles() {
+        var parameters = makeParameters(tileResolution: 8)
+        parameters.heightFunction = { uv, _ in sin(uv.x * 6.28) * 0.5 }
+
+        // every tile writes its own slot so the parallel callbacks don't race
+        let count: GeometryTileCallback = { tile, context in
+            let tile = tile!.pointee
+            let counts = context!.assumingMemoryBound(to: Int32.self)
+            counts[Int(tile.tileY * 7 + tile.tileX)] = tile.geometry.indexCount
+        }
+
+        var streamed = [Int32](repeating: 0, count: 7 * 4)
+        let tiles = generateGridTiles(&parameters, count, &streamed)
+        XCTAssertEqual(tiles, 7 * 4)
+        XCTAssertEqual(streamed.reduce(0, +), 50 * 30 * 2)
+
+        let system = createJobSystem(4)
+        defer { freeJobSystem(system) }
+
+        // the tiles run after the submit returns, so the context can't be an inout pointer
+        let parallel = UnsafeMutablePointer<Int32>.allocate(capacity: 7 * 4)
+        parallel.initialize(repeating: 0, count: 7 * 4)
+        defer { parallel.deallocate() }
+
+        let job = submitGridTileJobs(system, &parameters, count, parallel)
+        waitForJob(job)
+        releaseJob(job)
+        XCTAssertEqual(Array(UnsafeBufferPointer(start: parallel, count: 7 * 4)), streamed)
+    }
+
+    func testHeightFunctionRunsOncePerHaloPoint() {
+        var parameters = makeParameters(tileResolution: 16)
+        parameters.heightFunction = { uv, context in
+            context!.assumingMemoryBound(to: Int.self).pointee += 1
+            return uv.x
+        }
+
+        var calls = 0
+        withUnsafeMutablePointer(to: &calls) { counter in
+            parameters.heightContext = UnsafeMutableRawPointer(counter)
+            var tile = generateGridTile(&parameters, 1, 1)
+            defer { freeGeometryTile(&tile) }
+            XCTAssertEqual(counter.pointee, Int(tile.columns + 3) * Int(tile.rows + 3))
+        }
+    }
+
+    func testOversizedGridNeedsTiles() {
+        var vertices: Int32 = 0
+        var triangles: Int32 = 0
+        XCTAssertFalse(getGridGeometrySize(40000, 40000, &vertices, &triangles))
+        XCTAssertTrue(getGridGeometrySize(100, 100, &vertices, &triangles))
+        XCTAssertEqual(vertices, 101 * 101)
+        XCTAssertEqual(triangles, 100 * 100 * 2)
+
+        var plane = generatePlaneGeometryData(1, 1, 40000, 40000, 0, true)
+        XCTAssertEqual(plane.vertexCount, 0)
+        freeGeometryData(&plane)
+    }
+}
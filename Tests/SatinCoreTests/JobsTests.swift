@@ -0,0 +1,122 @@
+//
+//  JobsTests.swift
+//
+//
+//  Created by agent on 10/19/26.
+//
+
+import Foundation
+import SatinCore
+import XCTest
+
+class JobsTests: XCTestCase {
+    var system: OpaquePointer!
+
+    override func setUp() {
+        system = createJobSystem(4)
+    }
+
+    override func tearDown() {
+        freeJobSystem(system)
+    }
+
+    func testDependenciesAndCancel() {
+        // jobs outlive the calls that submit them, so their context can't be an inout pointer
+        let counter = UnsafeMutablePointer<Int32>.allocate(capacity: 1)
+        counter.initialize(to: 0)
+        defer { counter.deallocate() }
+
+        let increment: JobFunction = { context in
+            context!.assumingMemoryBound(to: Int32.self).pointee += 1
+        }
+
+        let first = submitJob(system, increment, counter, nil, 0)
+        var deps: [OpaquePointer?] = [first]
+        let second = submitJob(system, increment, counter, &deps, 1)
+        deps = [second]
+        let third = submitJob(system, increment, counter, &deps, 1)
+
+        waitForJob(third)
+        XCTAssertEqual(getJobStatus(first), JobStatusCompleted)
+        XCTAssertEqual(getJobStatus(second), JobStatusCompleted)
+        XCTAssertTrue(isJobFinished(third))
+        XCTAssertEqual(counter.pointee, 3)
+
+        // a job waiting on a blocked dependency can always be cancelled, its dependents are
+        // cancelled with it
+        let gate = DispatchSemaphore(value: 0)
+        let block: JobFunction = { context in
+            Unmanaged<DispatchSemaphore>.fromOpaque(context!).takeUnretainedValue().wait()
+        }
+        let blocker = submitJob(system, block, Unmanaged.passUnretained(gate).toOpaque(), nil, 0)
+        deps = [blocker]
+        let pending = submitJob(system, increment, counter, &deps, 1)
+        deps = [pending]
+        let child = submitJob(system, increment, counter, &deps, 1)
+
+        XCTAssertTrue(cancelJob(pending))
+        XCTAssertTrue(isJobFinished(pending))
+        XCTAssertEqual(getJobStatus(pending), JobStatusCancelled)
+        waitForJob(child)
+        XCTAssertEqual(getJobStatus(child), JobStatusCancelled)
+
+        gate.signal()
+        waitForJob(blocker)
+        XCTAssertEqual(getJobStatus(blocker), JobStatusCompleted)
+        XCTAssertEqual(counter.pointee, 3)
+
+        [first, second, third, blocker, pending, child].forEach { releaseJob($0) }
+    }
+
+    func testGeometryPipeline() {
+        let generator: GeometryGenerator = { _ in
+            generatePlaneGeometryData(2, 2, 32, 32, 0, true)
+        }
+
+        let geometry = UnsafeMutablePointer<GeometryData>.allocate(capacity: 1)
+        geometry.initialize(to: createGeometryData())
+        let bvh = UnsafeMutablePointer<BVH>.allocate(capacity: 1)
+        bvh.initialize(to: BVH())
+        defer {
+            geometry.deallocate()
+            bvh.deallocate()
+        }
+
+        let job = submitGeometryPipeline(system, generator, nil, true, geometry, bvh, true)
+        waitForJob(job)
+        releaseJob(job)
+
+        XCTAssertEqual(geometry.pointee.indexCount, 32 * 32 * 2)
+        XCTAssertGreaterThan(bvh.pointee.nodesUsed, 1)
+
+        freeBVH(bvh.pointee)
+        freeGeometryData(geometry)
+    }
+
+    func testCombineJob() {
+        let generator: GeometryGenerator = { _ in
+            generateBoxGeometryData(1, 1, 1, 0, 0, 0, 1, 1, 1)
+        }
+
+        var parts = [GeometryData](repeating: createGeometryData(), count: 8)
+        let combined = UnsafeMutablePointer<GeometryData>.allocate(capacity: 1)
+        combined.initialize(to: createGeometryData())
+        defer { combined.deallocate() }
+
+        parts.withUnsafeMutableBufferPointer { buffer in
+            var jobs: [OpaquePointer?] = (0 ..< buffer.count).map {
+                submitGenerateGeometryJob(system, generator, nil, buffer.baseAddress! + $0, nil, 0)
+            }
+            let combine = submitCombineGeometryJob(system, combined, buffer.baseAddress!, Int32(buffer.count), &jobs, Int32(jobs.count))
+            waitForJob(combine)
+            jobs.append(combine)
+            jobs.forEach { releaseJob($0) }
+        }
+
+        XCTAssertEqual(combined.pointee.vertexCount, parts.reduce(0) { $0 + $1.vertexCount })
+        XCTAssertEqual(combined.pointee.indexCount, parts.reduce(0) { $0 + $1.indexCount })
+
+        for i in 0 ..< parts.count { freeGeometryData(&parts[i]) }
+        freeGeometryData(combined)
+    }
+}
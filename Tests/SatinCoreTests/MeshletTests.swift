@@ -0,0 +1,81 @@
+//
+//  MeshletTests.swift
+//
+//
+//  Created by agent on 10/19/26.
+//
+
+import SatinCore
+import simd
+import XCTest
+
+class MeshletTests: XCTestCase {
+    func testMeshletsCoverEveryTriangle() {
+        var geometry = generateSphereGeometryData(1, 64, 48)
+        defer { freeGeometryData(&geometry) }
+
+        for indexSize in [1, 2] {
+            var data = buildMeshlets(&geometry, 64, 124, Int32(indexSize))
+            defer { freeMeshletData(&data) }
+
+            XCTAssertEqual(data.triangleCount, geometry.indexCount)
+
+            var triangles: [[UInt32]] = []
+            for m in 0 ..< Int(data.meshletCount) {
+                let meshlet = data.meshlets[m]
+                XCTAssertLessThanOrEqual(meshlet.vertexCount, 64)
+                XCTAssertLessThanOrEqual(meshlet.triangleCount, 124)
+
+                for v in 0 ..< Int(meshlet.vertexCount) {
+                    let p = simd_make_float3(geometry.vertexData[Int(data.vertices[Int(meshlet.vertexOffset) + v])].position)
+                    XCTAssertLessThanOrEqual(simd_distance(p, simd_make_float3(meshlet.sphere)), meshlet.sphere.w + 1e-5)
+                    XCTAssertTrue(simd_all(p .>= meshlet.bounds.min) && simd_all(p .<= meshlet.bounds.max))
+                }
+
+                for t in 0 ..< Int(meshlet.triangleCount) {
+                    let offset = (Int(meshlet.triangleOffset) + t) * 3
+                    let tri = (0 ..< 3).map { c -> UInt32 in
+                        let local = indexSize == 1 ?
+                            Int(data.triangles.load(fromByteOffset: offset + c, as: UInt8.self)) :
+                            Int(data.triangles.load(fromByteOffset: (offset + c) * 2, as: UInt16.self))
+                        return data.vertices[Int(meshlet.vertexOffset) + local]
+                    }
+                    triangles.append(tri)
+                }
+            }
+
+            let expected = (0 ..< Int(geometry.indexCount)).map { i -> [UInt32] in
+                let tri = geometry.indexData[i]
+                return [tri.i0, tri.i1, tri.i2]
+            }
+            XCTAssertEqual(triangles.sorted { $0.lexicographicallyPrecedes($1) }, expected.sorted { $0.lexicographicallyPrecedes($1) })
+        }
+    }
+
+    func testConeCulling() {
+        // faces +z
+        var geometry = generatePlaneGeometryData(2, 2, 32, 32, 0, true)
+        defer { freeGeometryData(&geometry) }
+
+        var data = buildMeshlets(&geometry, 64, 124, 1)
+        defer { freeMeshletData(&data) }
+
+        for m in 0 ..< Int(data.meshletCount) {
+            XCTAssertGreaterThan(simd_dot(simd_make_float3(data.meshlets[m].cone), simd_float3(0, 0, 1)), 0.99)
+        }
+
+        var visible = [UInt32](repeating: 0, count: Int(data.meshletCount))
+        XCTAssertEqual(cullMeshlets(&data, nil, 0, simd_float3(0, 0, 5), &visible), data.meshletCount)
+        XCTAssertEqual(cullMeshlets(&data, nil, 0, simd_float3(0, 0, -5), &visible), 0)
+
+        // only the meshlets on the positive x half are inside
+        let planes = [simd_float4(1, 0, 0, -0.5)]
+        let count = Int(cullMeshlets(&data, planes, 1, simd_float3(0, 0, 5), &visible))
+        XCTAssertGreaterThan(count, 0)
+        XCTAssertLessThan(count, Int(data.meshletCount))
+        for i in 0 ..< count {
+            let sphere = data.meshlets[Int(visible[i])].sphere
+            XCTAssertGreaterThanOrEqual(sphere.x + sphere.w, 0.5)
+        }
+    }
+}
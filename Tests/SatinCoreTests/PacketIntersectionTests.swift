@@ -0,0 +1,109 @@
+//
+//  PacketIntersectionTests.swift
+//
+//
+//  Created by agent on 10/19/26.
+//
+
+import SatinCore
+import simd
+import XCTest
+
+class PacketIntersectionTests: XCTestCase {
+    func randomPoint(_ range: ClosedRange<Float> = -1 ... 1) -> simd_float3 {
+        simd_float3(Float.random(in: range), Float.random(in: range), Float.random(in: range))
+    }
+
+    func randomRay() -> Ray {
+        Ray(origin: randomPoint(-4 ... 4), direction: simd_normalize(randomPoint()))
+    }
+
+    func testTrianglePackets() {
+        for _ in 0 ..< 1000 {
+            var packet4 = createTrianglePacket4()
+            var packet8 = createTrianglePacket8()
+            for lane in 0 ..< 8 {
+                let triangle = (randomPoint(), randomPoint(), randomPoint())
+                if lane < 4 { setTrianglePacket4(&packet4, Int32(lane), triangle.0, triangle.1, triangle.2) }
+                setTrianglePacket8(&packet8, Int32(lane), triangle.0, triangle.1, triangle.2)
+            }
+
+            let ray = randomRay()
+
+            var time4: Float = 0, time4s: Float = 0
+            var lane4: Int32 = -1, lane4s: Int32 = -1
+            let mask4 = rayTrianglePacket4Intersect(ray, &packet4, &time4, &lane4)
+            XCTAssertEqual(mask4, rayTrianglePacket4IntersectScalar(ray, &packet4, &time4s, &lane4s))
+            XCTAssertEqual(time4, time4s)
+            XCTAssertEqual(lane4, lane4s)
+
+            var time8: Float = 0, time8s: Float = 0
+            var lane8: Int32 = -1, lane8s: Int32 = -1
+            let mask8 = rayTrianglePacket8Intersect(ray, &packet8, &time8, &lane8)
+            XCTAssertEqual(mask8, rayTrianglePacket8IntersectScalar(ray, &packet8, &time8s, &lane8s))
+            XCTAssertEqual(time8, time8s)
+            XCTAssertEqual(lane8, lane8s)
+            XCTAssertEqual(mask8 & 0xF, mask4)
+        }
+    }
+
+    func testBoundsPackets() {
+        for _ in 0 ..< 1000 {
+            var packet4 = createBoundsPacket4()
+            var packet8 = createBoundsPacket8()
+            for lane in 0 ..< 7 {
+                let a = randomPoint(), b = randomPoint()
+                let bounds = Bounds(min: simd_min(a, b), max: simd_max(a, b))
+                if lane < 4 { setBoundsPacket4(&packet4, Int32(lane), bounds) }
+                setBoundsPacket8(&packet8, Int32(lane), bounds)
+            }
+
+            let ray = randomRay()
+
+            var time4: Float = 0, time4s: Float = 0
+            var lane4: Int32 = -1, lane4s: Int32 = -1
+            XCTAssertEqual(rayBoundsPacket4Intersect(ray, &packet4, &time4, &lane4),
+                           rayBoundsPacket4IntersectScalar(ray, &packet4, &time4s, &lane4s))
+            XCTAssertEqual(time4, time4s)
+            XCTAssertEqual(lane4, lane4s)
+
+            var time8: Float = 0, time8s: Float = 0
+            var lane8: Int32 = -1, lane8s: Int32 = -1
+            let mask8 = rayBoundsPacket8Intersect(ray, &packet8, &time8, &lane8)
+            XCTAssertEqual(mask8, rayBoundsPacket8IntersectScalar(ray, &packet8, &time8s, &lane8s))
+            XCTAssertEqual(time8, time8s)
+            XCTAssertEqual(lane8, lane8s)
+
+            // the last lane is empty and never hits
+            XCTAssertEqual(mask8 & (1 << 7), 0)
+        }
+    }
+
+    func testEdgePackets() {
+        func randomPoint2() -> simd_float2 {
+            // snap to a coarse grid so colinear & touching cases show up
+            simd_float2(Float(Int.random(in: -4 ... 4)), Float(Int.random(in: -4 ... 4))) * 0.25
+        }
+
+        for _ in 0 ..< 1000 {
+            let a = randomPoint2(), b = randomPoint2()
+            var edges = createEdgePacket4()
+            var points: [(simd_float2, simd_float2)] = []
+            for lane in 0 ..< 4 {
+                let c = randomPoint2(), d = randomPoint2()
+                points.append((c, d))
+                setEdgePacket4(&edges, Int32(lane), c, d)
+            }
+
+            let properMask = intersectsProperPacket4(a, b, &edges)
+            XCTAssertEqual(properMask, intersectsProperPacket4Scalar(a, b, &edges))
+            XCTAssertEqual(isLeftPacket4(a, b, edges.x0, edges.y0), isLeftPacket4Scalar(a, b, edges.x0, edges.y0))
+            XCTAssertEqual(isBetweenPacket4(a, b, edges.x0, edges.y0), isBetweenPacket4Scalar(a, b, edges.x0, edges.y0))
+
+            for (lane, (c, d)) in points.enumerated() {
+                XCTAssertEqual(intersectsProper(a, b, c, d), (properMask & (1 << lane)) != 0)
+                XCTAssertEqual(isBetween(a, b, c), (isBetweenPacket4(a, b, edges.x0, edges.y0) & (1 << lane)) != 0)
+            }
+        }
+    }
+}
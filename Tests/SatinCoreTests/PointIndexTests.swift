@@ -0,0 +1,94 @@
+//
+//  PointIndexTests.swift
+//
+//
+//  Created by agent on 10/19/26.
+//
+
+import SatinCore
+import simd
+import XCTest
+
+class PointIndexTests: XCTestCase {
+    let stride = UInt32(MemoryLayout<simd_float3>.stride)
+    var points: [simd_float3] = []
+    var system: OpaquePointer!
+
+    override func setUp() {
+        var generator = SystemRandomNumberGenerator()
+        points = (0 ..< 5000).map { _ in
+            simd_float3.random(in: -5 ... 5, using: &generator)
+        }
+        system = createJobSystem(4)
+    }
+
+    override func tearDown() {
+        freeJobSystem(system)
+    }
+
+    func nearest(to point: simd_float3, k: Int) -> [Float] {
+        Array(points.map { simd_distance(point, $0) }.sorted().prefix(k))
+    }
+
+    func testKdTreeMatchesBruteForce() {
+        let tree = createKdTree(points, stride, Int32(points.count), system)
+        defer { freeKdTree(tree) }
+
+        var ids = [UInt32](repeating: 0, count: 8)
+        var distances = [Float](repeating: 0, count: 8)
+        for query in points.prefix(50).map({ $0 + 0.1 }) {
+            XCTAssertEqual(queryKdTreeNearest(tree, query, 8, .infinity, &ids, &distances), 8)
+            for (found, expected) in zip(distances, nearest(to: query, k: 8)) {
+                XCTAssertEqual(found, expected, accuracy: 1e-5)
+            }
+
+            let expected = points.filter { simd_distance(query, $0) <= 1 }.count
+            var results = [UInt32](repeating: 0, count: points.count)
+            XCTAssertEqual(queryKdTreeRadius(tree, query, 1, &results, nil, Int32(points.count)), Int32(expected))
+        }
+
+        // moving points keeps queries exact
+        points[42] = simd_float3(20, 20, 20)
+        updateKdTreePoint(tree, 42, points[42])
+        XCTAssertEqual(queryKdTreeNearest(tree, simd_float3(19, 19, 19), 1, .infinity, &ids, nil), 1)
+        XCTAssertEqual(ids[0], 42)
+        XCTAssertEqual(getKdTreeBounds(tree).max, points[42])
+    }
+
+    func testPointGridMatchesKdTree() {
+        let tree = createKdTree(points, stride, Int32(points.count), system)
+        let grid = createPointGrid(points, stride, Int32(points.count), 0.5, system)
+        defer {
+            freeKdTree(tree)
+            freePointGrid(grid)
+        }
+
+        let queries = points.prefix(200).map { $0 + 0.05 }
+        let k = 6
+        var treeIds = [UInt32](repeating: 0, count: queries.count * k)
+        var gridIds = [UInt32](repeating: 0, count: queries.count * k)
+        var counts = [Int32](repeating: 0, count: queries.count)
+        queryKdTreeNearestBatch(tree, queries, Int32(queries.count), Int32(k), .infinity, &treeIds, nil, &counts, system)
+        XCTAssertTrue(counts.allSatisfy { $0 == k })
+        queryPointGridNearestBatch(grid, queries, Int32(queries.count), Int32(k), .infinity, &gridIds, nil, &counts, system)
+        XCTAssertTrue(counts.allSatisfy { $0 == k })
+        XCTAssertEqual(treeIds, gridIds)
+
+        let capacity = 64
+        var treeCounts = [Int32](repeating: 0, count: queries.count)
+        var results = [UInt32](repeating: 0, count: queries.count * capacity)
+        queryKdTreeRadiusBatch(tree, queries, Int32(queries.count), 0.4, &results, nil, Int32(capacity), &treeCounts, system)
+        queryPointGridRadiusBatch(grid, queries, Int32(queries.count), 0.4, &results, nil, Int32(capacity), &counts, system)
+        XCTAssertEqual(treeCounts, counts)
+
+        // moving every point across cells re-bins the grid
+        let moved = points.map { $0 + simd_float3(3, 0, 0) }
+        updatePointGridPoints(grid, moved, stride, nil, 0, system)
+        updateKdTreePoints(tree, moved, stride, nil, 0, system)
+        XCTAssertEqual(getPointGridPoint(grid, 7), moved[7])
+        XCTAssertEqual(queryPointGridNearest(grid, moved[7], 1, 0, &gridIds, nil), 1)
+        XCTAssertEqual(gridIds[0], 7)
+        XCTAssertEqual(queryKdTreeNearest(tree, moved[7], 1, 0, &treeIds, nil), 1)
+        XCTAssertEqual(treeIds[0], 7)
+    }
+}
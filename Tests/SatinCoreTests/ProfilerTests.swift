@@ -0,0 +1,95 @@
+//
+//  ProfilerTests.swift
+//
+//
+//  Created by agent on 10/19/26.
+//
+
+import SatinCore
+import XCTest
+
+class ProfilerTests: XCTestCase {
+    override func setUp() {
+        setProfilingEnabled(true)
+        resetProfileCounters()
+        clearProfileSpans()
+    }
+
+    override func tearDown() {
+        setProfilingEnabled(false)
+        resetProfileCounters()
+        clearProfileSpans()
+    }
+
+    func testGeneratorCounters() {
+        var box = generateBoxGeometryData(1, 1, 1, 0, 0, 0, 1, 1, 1)
+        XCTAssertEqual(getProfileCounter(ProfileCounterGeneratorCalls), 1)
+        XCTAssertEqual(getProfileCounter(ProfileCounterGeneratedVertices), UInt64(box.vertexCount))
+        XCTAssertEqual(getProfileCounter(ProfileCounterGeneratedTriangles), UInt64(box.indexCount))
+        XCTAssertEqual(getProfileSpanCount(), 1)
+
+        // Rounded box with a zero radius falls back to the box generator, counted once
+        var roundedBox = generateRoundedBoxGeometryData(1, 1, 1, 0, 1)
+        XCTAssertEqual(getProfileCounter(ProfileCounterGeneratorCalls), 2)
+        XCTAssertEqual(getProfileSpanCount(), 3)
+
+        freeGeometryData(&box)
+        freeGeometryData(&roundedBox)
+    }
+
+    func testTriangulatorAndBVHCounters() {
+        var square: [simd_float2] = [.init(0, 0), .init(1, 0), .init(1, 1), .init(0, 1)]
+        var lengths: [Int32] = [4]
+        var gData = createGeometryData()
+        square.withUnsafeMutableBufferPointer { ptr in
+            var paths: [UnsafeMutablePointer<simd_float2>?] = [ptr.baseAddress]
+            _ = triangulate(&paths, &lengths, 1, &gData)
+        }
+
+        XCTAssertEqual(gData.indexCount, 2)
+        XCTAssertGreaterThan(getProfileCounter(ProfileCounterTriangulatorEarTests), 0)
+        XCTAssertGreaterThan(getProfileCounter(ProfileCounterTriangulatorDiagonalEdgeChecks), 0)
+        XCTAssertEqual(getProfileCounter(ProfileCounterTriangulatorFailures), 0)
+
+        let bvh = createBVH(gData, true)
+        XCTAssertEqual(getProfileCounter(ProfileCounterBVHNodesBuilt), UInt64(bvh.nodesUsed))
+        freeBVH(bvh)
+
+        let path = FileManager.default.temporaryDirectory.appendingPathComponent("SatinCoreTrace.json").path
+        XCTAssertTrue(writeProfileTrace(path))
+        let data = try? Data(contentsOf: URL(fileURLWithPath: path))
+        XCTAssertNotNil(data.flatMap { try? JSONSerialization.jsonObject(with: $0) })
+
+        freeGeometryData(&gData)
+    }
+
+    func testSpanCapacity() {
+        setProfileSpanCapacity(2)
+        defer { setProfileSpanCapacity(1 << 18) }
+
+        for _ in 0 ..< 5 {
+            var plane = generatePlaneGeometryData(1, 1, 1, 1, 0, true)
+            freeGeometryData(&plane)
+        }
+        XCTAssertEqual(getProfileSpanCount(), 2)
+        XCTAssertEqual(getDroppedProfileSpanCount(), 3)
+
+        let path = FileManager.default.temporaryDirectory.appendingPathComponent("SatinCoreDroppedTrace.json").path
+        XCTAssertTrue(writeProfileTrace(path))
+        let data = try? Data(contentsOf: URL(fileURLWithPath: path))
+        let trace = data.flatMap { try? JSONSerialization.jsonObject(with: $0) } as? [String: Any]
+        let otherData = trace?["otherData"] as? [String: Any]
+        XCTAssertEqual(otherData?["droppedSpans"] as? Int, 3)
+
+        clearProfileSpans()
+        XCTAssertEqual(getDroppedProfileSpanCount(), 0)
+    }
+
+    func testDisabled() {
+        setProfilingEnabled(false)
+        var plane = generatePlaneGeometryData(1, 1, 1, 1, 0, true)
+        XCTAssertEqual(getProfileCounter(ProfileCounterGeneratorCalls), 0)
+        XCTAssertEqual(getProfileSpanCount(), 0)
+        freeGeometryData(&plane)
+    }
+}
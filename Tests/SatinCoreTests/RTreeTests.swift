@@ -0,0 +1,109 @@
+//
+//  RTreeTests.swift
+//
+//
+//  Created by agent on 10/19/26.
+//
+
+import SatinCore
+import simd
+import XCTest
+
+class RTreeTests: XCTestCase {
+    func randomRectangle() -> Rectangle {
+        let origin = simd_float2(Float.random(in: 0 ... 100), Float.random(in: 0 ... 100))
+        let size = simd_float2(Float.random(in: 0.1 ... 4), Float.random(in: 0.1 ... 4))
+        return Rectangle(min: origin, max: origin + size)
+    }
+
+    func query(_ tree: OpaquePointer, _ rect: Rectangle) -> Set<UInt32> {
+        var results = [UInt32](repeating: 0, count: 64)
+        var count = Int(queryRTreeRectangle(tree, rect, &results, Int32(results.count)))
+        if count > results.count {
+            results = [UInt32](repeating: 0, count: count)
+            count = Int(queryRTreeRectangle(tree, rect, &results, Int32(results.count)))
+        }
+        return Set(results[0 ..< count])
+    }
+
+    func bruteForce(_ rects: [UInt32: Rectangle], _ rect: Rectangle) -> Set<UInt32> {
+        Set(rects.filter { rectangleIntersectsRectangle($0.value, rect) }.map { $0.key })
+    }
+
+    func testQueriesMatchBruteForce() {
+        var rects = (0 ..< 2000).map { _ in randomRectangle() }
+        let tree = createRTree(&rects, nil, Int32(rects.count))!
+        defer { freeRTree(tree) }
+
+        var items: [UInt32: Rectangle] = [:]
+        for (i, rect) in rects.enumerated() { items[UInt32(i)] = rect }
+
+        XCTAssertEqual(getRTreeCount(tree), 2000)
+
+        for _ in 0 ..< 100 {
+            let rect = randomRectangle()
+            XCTAssertEqual(query(tree, rect), bruteForce(items, rect))
+
+            let pt = rect.min
+            var results = [UInt32](repeating: 0, count: 64)
+            let count = Int(queryRTreePoint(tree, pt, &results, 64))
+            XCTAssertEqual(Set(results[0 ..< min(count, 64)]), Set(items.filter { rectangleContainsPoint($0.value, pt) }.map { $0.key }))
+        }
+    }
+
+    func testInsertRemoveUpdate() {
+        var rects: [Rectangle] = []
+        let tree = createRTree(&rects, nil, 0)!
+        defer { freeRTree(tree) }
+
+        var items: [UInt32: Rectangle] = [:]
+        for i in 0 ..< 1000 {
+            let rect = randomRectangle()
+            insertRTree(tree, UInt32(i), rect)
+            items[UInt32(i)] = rect
+        }
+
+        for i in stride(from: 0, to: 1000, by: 3) {
+            XCTAssertTrue(removeRTree(tree, UInt32(i)))
+            items.removeValue(forKey: UInt32(i))
+        }
+        XCTAssertFalse(removeRTree(tree, 0))
+
+        for i in stride(from: 1, to: 1000, by: 3) {
+            let rect = randomRectangle()
+            XCTAssertTrue(updateRTree(tree, UInt32(i), rect))
+            items[UInt32(i)] = rect
+        }
+
+        XCTAssertEqual(Int(getRTreeCount(tree)), items.count)
+
+        let all = Rectangle(min: .init(-1, -1), max: .init(200, 200))
+        XCTAssertEqual(query(tree, all), Set(items.keys))
+
+        for _ in 0 ..< 100 {
+            let rect = randomRectangle()
+            XCTAssertEqual(query(tree, rect), bruteForce(items, rect))
+        }
+    }
+
+    func testNearest() {
+        var rects = (0 ..< 500).map { _ in randomRectangle() }
+        let tree = createRTree(&rects, nil, Int32(rects.count))!
+        defer { freeRTree(tree) }
+
+        func distance(_ rect: Rectangle, _ pt: simd_float2) -> Float {
+            simd_length(simd_max(simd_max(rect.min - pt, pt - rect.max), .zero))
+        }
+
+        let pt = simd_float2(50, 50)
+        var results = [UInt32](repeating: 0, count: 8)
+        var distances = [Float](repeating: 0, count: 8)
+        XCTAssertEqual(queryRTreeNearest(tree, pt, 8, &results, &distances), 8)
+
+        let expected = rects.map { distance($0, pt) }.sorted()
+        for i in 0 ..< 8 {
+            XCTAssertEqual(distances[i], expected[i], accuracy: 1e-5)
+            XCTAssertEqual(distances[i], distance(rects[Int(results[i])], pt), accuracy: 1e-5)
+        }
+    }
+}
@@ -34,7 +34,7 @@ class TriangulatorTests: XCTestCase {
     func testTriangulate() {
         var (_lengths, _paths) = buildPaths()
 
-        var cData = GeometryData(vertexCount: 0, vertexData: nil, indexCount: 0, indexData: nil)
+        var cData = createGeometryData()
         triangulate(&_paths, &_lengths, 3, &cData)
 
         XCTAssertEqual(cData.vertexCount, 161)
@@ -57,7 +57,7 @@ class TriangulatorTests: XCTestCase {
 
         measure {
             for _ in 0..<100 {
-                var cData = GeometryData(vertexCount: 0, vertexData: nil, indexCount: 0, indexData: nil)
+                var cData = createGeometryData()
                 triangulate(&_paths, &_lengths, 3, &cData)
                 freeGeometryData(&cData)
             }
@@ -0,0 +1,47 @@
+//
+//  BVHTests.swift
+//
+//
+//  Created by agent on 10/19/26.
+//
+
+import Satin
+import SatinCore
+import simd
+import XCTest
+
+class BVHTests: XCTestCase {
+    func testIntersectPositionOnlyBVH() {
+        // two unindexed triangles stacked along z, packed as float3
+        let positions: [Float] = [0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0, 1, 1, 0, 1, 0, 1, 1]
+        positions.withUnsafeBytes { bytes in
+            let bvh = createBVHFromPositions(bytes.baseAddress, 12, 6, nil, 0, false)
+            defer { freeBVH(bvh) }
+            XCTAssertFalse(bvh.hasVertices)
+
+            var intersections: [IntersectionResult] = []
+            let ray = Ray(origin: simd_float3(0.25, 0.25, 2), direction: simd_float3(0, 0, -1))
+            bvh.intersect(ray: ray, intersections: &intersections)
+
+            XCTAssertEqual(intersections.count, 2)
+            let distances = intersections.map { $0.distance }.sorted()
+            XCTAssertEqual(distances[0], 1, accuracy: 1e-5)
+            XCTAssertEqual(distances[1], 2, accuracy: 1e-5)
+            XCTAssertTrue(intersections.allSatisfy { $0.uv == .zero })
+        }
+    }
+
+    func testIntersectGeometryBVHReportsUVs() {
+        var plane = generatePlaneGeometryData(2, 2, 1, 1, 0, true)
+        defer { freeGeometryData(&plane) }
+
+        let bvh = createBVH(plane, false)
+        defer { freeBVH(bvh) }
+        XCTAssertTrue(bvh.hasVertices)
+
+        var intersections: [IntersectionResult] = []
+        bvh.intersect(ray: Ray(origin: simd_float3(0, 0, 1), direction: simd_float3(0, 0, -1)), intersections: &intersections)
+        XCTAssertEqual(intersections.count, 1)
+        XCTAssertEqual(intersections.first?.uv.x ?? 0, 0.5, accuracy: 1e-5)
+    }
+}
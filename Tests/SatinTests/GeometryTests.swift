@@ -0,0 +1,46 @@
+//
+//  GeometryTests.swift
+//
+//
+//  Created by agent on 10/19/26.
+//
+
+import Satin
+import SatinCore
+import simd
+import XCTest
+
+class GeometryTests: XCTestCase {
+    func testReadingDataKeepsAdoptedStorage() {
+        var plane = generatePlaneGeometryData(2, 2, 4, 4, 0, true)
+        let geometry = Geometry()
+        geometry.adopt(&plane)
+
+        let vertices = geometry.getGeometryData().vertexData
+        XCTAssertEqual(geometry.vertexData.count, 25)
+        XCTAssertEqual(geometry.indexData.count, 96)
+        XCTAssertNotNil(geometry.bvh)
+        XCTAssertEqual(geometry.getGeometryData().vertexData, vertices)
+        XCTAssertEqual(geometry.bvh?.positions, UnsafeRawPointer(vertices))
+    }
+
+    func testMutatingCopiesStorageTheBVHReads() {
+        var plane = generatePlaneGeometryData(2, 2, 1, 1, 0, true)
+        let geometry = Geometry()
+        geometry.adopt(&plane)
+
+        let bvhPositions = geometry.bvh?.positions
+        geometry.transform(translationMatrixf(0, 0, 1))
+
+        XCTAssertNotEqual(UnsafeRawPointer(geometry.getGeometryData().vertexData), bvhPositions)
+        XCTAssertEqual(bvhPositions?.load(as: Vertex.self).position.z, 0)
+        XCTAssertEqual(geometry.bounds.max.z, 1)
+    }
+
+    func testLineIndicesRoundTrip() {
+        let geometry = Geometry(primitiveType: .line)
+        geometry.indexData = [0, 1, 1, 2]
+        XCTAssertEqual(geometry.indexCount, 4)
+        XCTAssertEqual(geometry.indexData, [0, 1, 1, 2])
+    }
+}